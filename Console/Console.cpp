@@ -1,5 +1,7 @@
+#include <array>
 #include <iostream>
 #include <filesystem>
+#include <string_view>
 
 #include "shared/environment_repository.h"
 #include "shared/process_service.h"
@@ -27,9 +29,12 @@ int main()
         auto const envVar = environment->get_variable("Hello");
         cout << envVar.value_or("no value found") << endl;
 
-        auto processes = processService->get_processes_by_name("svchost.exe");
-        for (auto const& p : processes)
-            cout << "Process ID: " << p->get_id() << endl;
+        std::array<std::string_view, 2> const names{"svchost.exe", "explorer.exe"};
+        auto const processesByName = processService->get_processes_by_names(names);
+        for (std::size_t i = 0; i < names.size(); i++) {
+            for (auto const& p : processesByName[i])
+                cout << names[i] << " Process ID: " << p->get_id() << endl;
+        }
     }
     catch (std::exception const& e) {
         cout << "Unexpected error occured: " << e.what() << endl;
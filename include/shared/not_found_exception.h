@@ -13,13 +13,15 @@
 
 #pragma once
 
+#include <stdexcept>
+
 namespace shared::infrastructure
 {
-    class not_found_exception final : public std::exception
+    class not_found_exception final : public std::runtime_error
     {
     public:
         explicit not_found_exception(char const * const what)
-            : exception(what)
+            : runtime_error(what)
         {
         }
         not_found_exception(not_found_exception const&) = default;
@@ -14,17 +14,43 @@
 #pragma once
 
 #include <filesystem>
+#include <future>
 #include <optional>
+#include <span>
 #include "shared/shared_export.h"
 
 namespace shared::model
 {
+    /// <summary>completes with the exit code of a process once it has exited</summary>
+    using exit_future = std::shared_future<std::optional<unsigned long>>;
+
+    /// <summary>what becomes of a launched process once the process object which launched it is destroyed</summary>
+    enum class process_ownership
+    {
+        /// <summary>process keeps running, its exit is still collected in the background</summary>
+        DETACH,
+        /// <summary>process is killed if it is still running</summary>
+        KILL_ON_DROP,
+    };
+
     struct process
     {
         [[nodiscard]] SHARED_DLL virtual unsigned long get_id() const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual bool is_running() const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::optional<unsigned long> exit_code() const noexcept = 0;
         SHARED_DLL virtual void wait_for_exit() const noexcept = 0;
+        /// <summary>returns a future which completes once the process exits without tying up a thread per process</summary>
+        /// <remarks>
+        /// completes with nullopt where the exit code cannot be collected, on linux that is any process
+        /// which was not launched by this one
+        /// </remarks>
+        [[nodiscard]] SHARED_DLL virtual exit_future when_exited() const = 0;
+        /// <summary>reads redirected standard output into buffer, blocking until some is available</summary>
+        /// <returns>the number of bytes read, zero once the stream has ended or when output was not redirected</returns>
+        [[nodiscard]] SHARED_DLL virtual std::size_t read_standard_output(std::span<char> const buffer) const noexcept = 0;
+        /// <summary>reads redirected standard error into buffer, blocking until some is available</summary>
+        /// <returns>the number of bytes read, zero once the stream has ended or when error was not redirected</returns>
+        [[nodiscard]] SHARED_DLL virtual std::size_t read_standard_error(std::span<char> const buffer) const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& processName) const noexcept = 0;
 
         SHARED_DLL process() = default;
@@ -0,0 +1,62 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <functional>
+#include <span>
+#include <string_view>
+
+namespace shared::model
+{
+    /// <summary>kind of change reported by a process table refresh</summary>
+    enum class process_change
+    {
+        /// <summary>process was not present in the previous refresh</summary>
+        STARTED,
+        /// <summary>process present in the previous refresh is no longer running</summary>
+        EXITED,
+        /// <summary>process is still running but its name, parent or thread count changed</summary>
+        CHANGED,
+    };
+
+    /// <summary>identifies a process across refreshes, the start time distinguishes processes which reuse a process id</summary>
+    struct process_key
+    {
+        unsigned long process_id{};
+        unsigned long long start_time{};
+
+        bool operator==(process_key const& other) const noexcept = default;
+    };
+
+    struct process_delta
+    {
+        process_change change{};
+        process_key key{};
+        unsigned long parent_process_id{};
+        unsigned long thread_count{};
+        /// <summary>executable name, only valid for the duration of the handler it was published to</summary>
+        std::string_view name{};
+    };
+
+    using process_delta_handler = std::function<void(std::span<process_delta const>)>;
+}
+
+template <>
+struct std::hash<shared::model::process_key>
+{
+    std::size_t operator()(shared::model::process_key const& key) const noexcept
+    {
+        return std::hash<unsigned long long>()((static_cast<unsigned long long>(key.process_id) << 32) ^ key.start_time);
+    }
+};
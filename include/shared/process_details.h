@@ -0,0 +1,37 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace shared::model
+{
+    /// <summary>point in time details of a running process, as gathered by process_service::collect_details</summary>
+    struct process_details
+    {
+        unsigned long process_id{};
+        /// <summary>false when the process was not running or could not be read, leaving the remaining fields empty</summary>
+        bool available{};
+        unsigned long thread_count{};
+        /// <summary>resident set on linux, working set on windows</summary>
+        std::uint64_t resident_bytes{};
+        /// <summary>anonymous resident memory on linux, private commit on windows</summary>
+        std::uint64_t private_bytes{};
+        /// <summary>executable images mapped into the process, the main executable first</summary>
+        std::vector<std::filesystem::path> modules{};
+    };
+
+}
@@ -15,9 +15,13 @@
 
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <vector>
 #include <regex>
 #include "shared/process.h"
+#include "shared/process_delta.h"
+#include "shared/process_details.h"
+#include "shared/process_start_info.h"
 #include "shared/shared_export.h"
 
 namespace shared::service
@@ -26,9 +30,31 @@ namespace shared::service
     {
         using unique_process = shared::model::unique_process;
 
+        /// <summary>starts filename, detaching from it once the returned process is destroyed</summary>
         [[nodiscard]] SHARED_DLL virtual unique_process start_process(std::string_view const& filename, std::string_view const& arguments) const noexcept = 0;
+        /// <summary>starts filename, with ownership deciding whether it outlives the returned process</summary>
+        /// <remarks>destroying the returned process never waits for it to exit</remarks>
+        [[nodiscard]] SHARED_DLL virtual unique_process start_process(std::string_view const& filename, std::string_view const& arguments, shared::model::process_ownership const ownership) const noexcept = 0;
+        /// <summary>starts the process described by start_info, returning null if it could not be started</summary>
+        [[nodiscard]] SHARED_DLL virtual unique_process start_process(shared::model::process_start_info const& start_info) const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::vector<unique_process> get_processes_by_name(std::string_view const& processName) const noexcept = 0;
+        /// <summary>matches every name in process_names against a single poll of the running processes</summary>
+        /// <returns>one entry per requested name, in the order requested, empty where nothing matched</returns>
+        [[nodiscard]] SHARED_DLL virtual std::vector<std::vector<unique_process>> get_processes_by_names(std::span<std::string_view const> const process_names) const noexcept = 0;
         [[nodiscard]] SHARED_DLL virtual std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& processName) const noexcept = 0;
+        /// <summary>gathers thread count, memory counters and modules of each process, spreading the work over one thread per core</summary>
+        /// <returns>one entry per requested process id, in the order requested</returns>
+        [[nodiscard]] SHARED_DLL virtual std::vector<shared::model::process_details> collect_details(std::span<unsigned long const> const process_ids) const noexcept = 0;
+
+        /// <summary>registers handler to receive the started, exited and changed processes found by each refresh</summary>
+        /// <remarks>
+        /// handlers run on the refreshing thread while the process table is locked and must not call back into the
+        /// service; an exception thrown by one is discarded and the other handlers still receive the deltas
+        /// </remarks>
+        [[nodiscard]] SHARED_DLL virtual std::size_t subscribe(shared::model::process_delta_handler handler) = 0;
+        SHARED_DLL virtual void unsubscribe(std::size_t const subscription) noexcept = 0;
+        /// <summary>polls the running processes, publishing any differences from the previous poll to subscribers</summary>
+        SHARED_DLL virtual void refresh() noexcept = 0;
 
         process_service() = default;
         virtual ~process_service() = default;
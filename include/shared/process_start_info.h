@@ -0,0 +1,39 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include "shared/process.h"
+
+namespace shared::model
+{
+    /// <summary>everything needed to launch a process through process_service::start_process</summary>
+    struct process_start_info
+    {
+        std::filesystem::path filename{};
+        /// <summary>arguments following the filename, each passed to the process as given without splitting</summary>
+        std::vector<std::string> arguments{};
+        /// <summary>NAME=value entries which replace the environment of the new process, when unset it inherits ours</summary>
+        std::optional<std::vector<std::string>> environment{};
+        /// <summary>connects standard output to a pipe read through process::read_standard_output</summary>
+        bool redirect_standard_output{};
+        /// <summary>connects standard error to a pipe read through process::read_standard_error</summary>
+        bool redirect_standard_error{};
+        process_ownership ownership{process_ownership::DETACH};
+    };
+
+}
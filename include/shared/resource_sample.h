@@ -0,0 +1,37 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace shared::model
+{
+    /// <summary>resource usage of one process at the time it was taken</summary>
+    struct resource_sample
+    {
+        std::chrono::steady_clock::time_point taken{};
+        /// <summary>cpu time consumed since the process started</summary>
+        std::chrono::nanoseconds user_time{};
+        std::chrono::nanoseconds system_time{};
+        /// <summary>resident set on linux, working set on windows</summary>
+        std::uint64_t resident_bytes{};
+        /// <summary>resident pages not shared with other processes on linux, private commit on windows</summary>
+        std::uint64_t private_bytes{};
+        unsigned long thread_count{};
+        /// <summary>open file descriptors on linux, open handles on windows</summary>
+        unsigned long handle_count{};
+    };
+
+}
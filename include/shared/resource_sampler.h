@@ -0,0 +1,65 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "shared/process.h"
+#include "shared/resource_sample.h"
+#include "shared/shared_export.h"
+
+namespace shared::service
+{
+    /// <summary>samples the resource usage of a set of processes, either on demand or on a fixed interval</summary>
+    /// <remarks>
+    /// each process keeps its most recent samples in a ring buffer sized when the sampler is made, so once
+    /// every target has been added sampling allocates nothing however long it runs
+    /// </remarks>
+    struct resource_sampler
+    {
+        using unique_process = shared::model::unique_process;
+        using resource_sample = shared::model::resource_sample;
+
+        /// <summary>adds target to the processes sampled, returning false if it is not running or already present</summary>
+        /// <remarks>a target reusing the id of an exited process replaces it, samples of the exited process are dropped</remarks>
+        [[nodiscard]] SHARED_DLL virtual bool add(unique_process target) = 0;
+        SHARED_DLL virtual void remove(unsigned long const process_id) noexcept = 0;
+        [[nodiscard]] SHARED_DLL virtual std::size_t size() const noexcept = 0;
+
+        /// <summary>takes one sample of every target, targets which have exited keep their samples but are no longer sampled</summary>
+        SHARED_DLL virtual void sample() noexcept = 0;
+        /// <summary>samples every interval on a background thread until stop is called or the sampler is destroyed</summary>
+        SHARED_DLL virtual void start(std::chrono::milliseconds const interval) = 0;
+        SHARED_DLL virtual void stop() noexcept = 0;
+
+        /// <summary>returns the samples held for process_id, oldest first</summary>
+        [[nodiscard]] SHARED_DLL virtual std::vector<resource_sample> get_samples(unsigned long const process_id) const = 0;
+
+        resource_sampler() = default;
+        virtual ~resource_sampler() = default;
+        resource_sampler(resource_sampler const&) = delete;
+        resource_sampler& operator=(resource_sampler const&) = delete;
+        resource_sampler(resource_sampler&&) noexcept = default;
+        resource_sampler& operator=(resource_sampler&&) noexcept = default;
+    };
+
+    using shared_resource_sampler = std::shared_ptr<resource_sampler>;
+    using unique_resource_sampler = std::unique_ptr<resource_sampler>;
+
+    /// <param name="samples_per_process">capacity of the ring buffer kept for each target</param>
+    /// <exception cref="std::invalid_argument">when samples_per_process is zero</exception>
+    [[nodiscard]] SHARED_DLL unique_resource_sampler make_resource_sampler(std::size_t const samples_per_process);
+
+}
@@ -0,0 +1,83 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+namespace shared::infrastructure
+{
+    /// <summary>keeps the most recent capacity values, overwriting the oldest once full</summary>
+    /// <remarks>storage is allocated once on construction so pushing never allocates</remarks>
+    template <typename VALUE>
+    class ring_buffer final
+    {
+    public:
+        void push(VALUE const& value)
+        {
+            m_values[(m_first + m_size) % m_values.size()] = value;
+            if (m_size < m_values.size())
+                m_size++;
+            else
+                m_first = (m_first + 1) % m_values.size();
+        }
+        void clear() noexcept
+        {
+            m_first = 0;
+            m_size = 0;
+        }
+
+        /// <summary>returns the value at index counting from the oldest</summary>
+        /// <remarks>index must be less than size(), like std::vector the index is not checked in release builds</remarks>
+        [[nodiscard]] VALUE const& operator[](std::size_t const index) const noexcept
+        {
+            assert(index < m_size);
+            return m_values[(m_first + index) % m_values.size()];
+        }
+        /// <summary>returns the most recently pushed value</summary>
+        /// <remarks>the buffer must not be empty</remarks>
+        [[nodiscard]] VALUE const& back() const noexcept
+        {
+            assert(m_size != 0);
+            return (*this)[m_size - 1];
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return m_values.size();
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        /// <exception cref="std::invalid_argument">when capacity is zero</exception>
+        explicit ring_buffer(std::size_t const capacity)
+            : m_values(capacity)
+        {
+            if (capacity == 0)
+                throw std::invalid_argument("ring_buffer capacity must be positive");
+        }
+
+    private:
+        std::vector<VALUE> m_values;
+        std::size_t m_first{};
+        std::size_t m_size{};
+    };
+
+}
@@ -13,8 +13,12 @@
 
 #pragma once
 
-#ifdef SHARED_DLL_EXPORT
-#   define SHARED_DLL __declspec(dllexport)
+#if defined(_WIN32)
+#   ifdef SHARED_DLL_EXPORT
+#       define SHARED_DLL __declspec(dllexport)
+#   else
+#       define SHARED_DLL __declspec(dllimport)
+#   endif
 #else
-#   define SHARED_DLL __declspec(dllimport)
+#   define SHARED_DLL __attribute__((visibility("default")))
 #endif
@@ -0,0 +1,58 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace snapshot::model
+{
+    /// <summary>format of a umdh output file</summary>
+    enum class umdh_format
+    {
+        /// <summary>no record has been read yet</summary>
+        UNKNOWN,
+        /// <summary>single snapshot written by umdh -p, sizes and counts are hexadecimal</summary>
+        LOG,
+        /// <summary>comparison of two logs written by umdh old new, sizes and counts are in the base given by umdh_radix</summary>
+        DIFF,
+    };
+
+    /// <summary>base of the sizes and counts in a umdh diff</summary>
+    enum class umdh_radix
+    {
+        /// <summary>written by umdh old new</summary>
+        HEXADECIMAL,
+        /// <summary>written by umdh -d old new</summary>
+        DECIMAL,
+    };
+
+    /// <summary>one backtrace entry of a umdh log or diff</summary>
+    /// <remarks>
+    /// frames view the text being parsed rather than copies of it and are only valid while that text is,
+    /// for logs the previous values are always zero
+    /// </remarks>
+    struct umdh_record
+    {
+        std::uint64_t backtrace_id{};
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        std::uint64_t previous_bytes{};
+        std::uint64_t previous_count{};
+        /// <summary>innermost frame first, as umdh writes them</summary>
+        std::vector<std::string_view> frames{};
+    };
+
+}
@@ -0,0 +1,217 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <tasks/executor.h>
+#include <tasks/task.h>
+
+namespace tasks
+{
+    /// <summary>lazily started coroutine producing a VALUE, awaiting it runs it and resumes the awaiter once it returns</summary>
+    /// <remarks>
+    /// control passes between the awaiter and the coroutine by symmetric transfer so long chains of awaits
+    /// neither grow the stack nor block a thread; combined with resume_on a step which would otherwise park
+    /// a thread on a future instead gives its thread back to the executor until it can continue.
+    /// a co_task must outlive any resume_on hop it has pending: destroying or assigning over one which has
+    /// started but not finished frees the frame an executor is yet to resume, debug builds assert on it
+    /// </remarks>
+    template <typename VALUE>
+    class co_task final
+    {
+        static_assert(!std::is_void_v<VALUE> && !std::is_reference_v<VALUE>, "co_task produces a value");
+
+    public:
+        class promise_type final
+        {
+        public:
+            co_task get_return_object() noexcept
+            {
+                return co_task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+            auto final_suspend() const noexcept
+            {
+                struct final_awaiter
+                {
+                    bool await_ready() const noexcept
+                    {
+                        return false;
+                    }
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> const handle) const noexcept
+                    {
+                        return handle.promise().m_continuation;
+                    }
+                    void await_resume() const noexcept
+                    {
+                    }
+                };
+                return final_awaiter{};
+            }
+            template <typename RESULT>
+            void return_value(RESULT&& value)
+            {
+                m_result.template emplace<1>(std::forward<RESULT>(value));
+            }
+            void unhandled_exception() noexcept
+            {
+                m_result.template emplace<2>(std::current_exception());
+            }
+
+        private:
+            friend class co_task;
+            std::coroutine_handle<> m_continuation{std::noop_coroutine()};
+            bool m_started{};
+            std::variant<std::monostate, VALUE, std::exception_ptr> m_result{};
+        };
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> const awaiting) noexcept
+        {
+            m_handle.promise().m_continuation = awaiting;
+            m_handle.promise().m_started = true;
+            return m_handle;
+        }
+        VALUE await_resume()
+        {
+            return result();
+        }
+
+        /// <summary>runs the coroutine on the calling thread until it first suspends or returns</summary>
+        /// <remarks>for starting a chain outside a coroutine, awaiting is the way to run one from inside</remarks>
+        void start()
+        {
+            m_handle.promise().m_started = true;
+            m_handle.resume();
+        }
+        /// <summary>true once the coroutine has returned or thrown</summary>
+        /// <remarks>
+        /// when the coroutine finishes on an executor, read this only after something which synchronizes
+        /// with it, such as executor::wait_idle
+        /// </remarks>
+        [[nodiscard]] bool done() const noexcept
+        {
+            return m_handle && m_handle.done();
+        }
+        /// <summary>value returned by the finished coroutine</summary>
+        /// <exception cref="std::logic_error">when the coroutine has not finished</exception>
+        /// <exception cref="std::exception">the exception which ended the coroutine</exception>
+        VALUE result()
+        {
+            auto& promise = m_handle.promise();
+            if (promise.m_result.index() == 2)
+                std::rethrow_exception(std::get<2>(promise.m_result));
+            if (promise.m_result.index() != 1)
+                throw std::logic_error("co_task has not finished");
+            return std::move(std::get<1>(promise.m_result));
+        }
+
+        co_task(co_task const&) = delete;
+        co_task& operator=(co_task const&) = delete;
+        co_task(co_task&& other) noexcept
+            : m_handle(std::exchange(other.m_handle, {}))
+        {
+        }
+        co_task& operator=(co_task&& other) noexcept
+        {
+            if (this != &other) {
+                destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+        ~co_task()
+        {
+            destroy();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle{};
+
+        void destroy() noexcept
+        {
+            if (!m_handle)
+                return;
+            assert((!m_handle.promise().m_started || m_handle.done()) && "co_task destroyed while its coroutine is suspended");
+            m_handle.destroy();
+        }
+
+        explicit co_task(std::coroutine_handle<promise_type> const handle) noexcept
+            : m_handle(handle)
+        {
+        }
+    };
+
+    /// <summary>awaiter which suspends the awaiting coroutine and resumes it on a worker of an executor</summary>
+    /// <remarks>
+    /// the task submitted to the executor lives in the coroutine frame alongside this awaiter, so no allocation
+    /// is made per hop; the executor does not touch the task once it has resumed the coroutine, which may by
+    /// then have finished and freed the frame
+    /// </remarks>
+    class executor_awaiter final
+    {
+    public:
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> const awaiting)
+        {
+            m_resume.awaiting = awaiting;
+            m_pool->submit(m_resume);
+        }
+        void await_resume() const noexcept
+        {
+        }
+
+        explicit executor_awaiter(executor& pool) noexcept
+            : m_pool(&pool)
+        {
+        }
+
+    private:
+        class resume_task final : public task
+        {
+        public:
+            std::coroutine_handle<> awaiting{};
+
+            void process() override
+            {
+                awaiting.resume();
+            }
+        };
+
+        executor* m_pool;
+        resume_task m_resume{};
+    };
+
+    /// <summary>co_await resume_on(pool) continues the current coroutine on one of pool's workers</summary>
+    [[nodiscard]] inline executor_awaiter resume_on(executor& pool) noexcept
+    {
+        return executor_awaiter(pool);
+    }
+
+}
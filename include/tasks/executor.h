@@ -0,0 +1,83 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <tasks/task.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+    struct executor_worker;
+
+    /// <summary>runs tasks on a fixed pool of threads, each with its own work stealing deque</summary>
+    /// <remarks>
+    /// tasks submitted from a worker go on that worker's deque, so a task fanning out into more tasks never
+    /// contends with other workers; idle workers steal the oldest task from a busy one. tasks submitted from
+    /// any other thread go through a shared queue. tasks are not owned and must outlive their processing
+    /// </remarks>
+    class executor final
+    {
+    public:
+        template <Task TASK>
+        void submit(TASK& work)
+        {
+            submit(static_cast<task&>(work));
+        }
+        /// <remarks>a READY task is moved to RUNNING while it is processed then to COMPLETE, or FAILED if it throws</remarks>
+        TASKS_DLL void submit(task& work);
+
+        /// <summary>blocks until every task submitted so far has been processed</summary>
+        /// <remarks>must not be called from a task run by this executor</remarks>
+        /// <exception cref="std::exception">the first exception thrown by a task since the previous wait</exception>
+        TASKS_DLL void wait_idle();
+        [[nodiscard]] TASKS_DLL std::size_t worker_count() const noexcept;
+
+        /// <param name="workers">number of threads, zero for one per hardware thread</param>
+        TASKS_DLL explicit executor(std::size_t workers = 0);
+        executor(executor const&) = delete;
+        executor& operator=(executor const&) = delete;
+        executor(executor&&) = delete;
+        executor& operator=(executor&&) = delete;
+        /// <summary>processes any tasks still queued then stops the workers</summary>
+        TASKS_DLL ~executor();
+
+    private:
+        std::vector<std::unique_ptr<executor_worker>> m_workers{};
+        std::mutex m_shared_lock{};
+        std::deque<task*> m_shared{};
+        std::atomic<bool> m_shared_empty{true};
+        std::atomic<std::uint64_t> m_pending{};
+        std::atomic<std::uint32_t> m_epoch{};
+        std::atomic<std::uint32_t> m_sleeping{};
+        std::atomic<bool> m_stopping{};
+        std::mutex m_error_lock{};
+        std::exception_ptr m_error{};
+        std::vector<std::jthread> m_threads{};
+
+        void run(std::size_t const index);
+        [[nodiscard]] task* find_work(executor_worker& worker);
+        [[nodiscard]] task* take_shared();
+        void process(task& work);
+        void wake() noexcept;
+    };
+
+}
@@ -13,7 +13,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <tasks/task_state.h>
 #include <tasks/tasks_export.h>
 #include <future>
@@ -22,31 +25,78 @@ namespace tasks
 {
 
     /// <summary>Represents a repeatble asynchronous operation with state that determines whether the operation can be run</summary>
-    /// <remarks>not intended for direct use but serving as a base class and basis for a task concept</remarks>
+    /// <remarks>
+    /// <para>not intended for direct use but serving as a base class and basis for a task concept</para>
+    /// <para>
+    /// state moves PENDING to READY to RUNNING to COMPLETE or FAILED, then back to READY when the task is
+    /// repeated; every transition is a compare and swap so racing transitions cannot both succeed, and state
+    /// and time remaining can be read from any thread without locking
+    /// </para>
+    /// </remarks>
     class task  
     {
     public:
-        TASKS_DLL task(task const&) = default;
-        TASKS_DLL task(task&&) noexcept = default;
+        using clock = std::chrono::steady_clock;
+
+        TASKS_DLL task(task const& other) noexcept;
+        TASKS_DLL task(task&& other) noexcept;
         TASKS_DLL virtual ~task() = default;
 
-        TASKS_DLL task& operator=(task const&) = default;
-        TASKS_DLL task& operator=(task&&) noexcept = default;
+        TASKS_DLL task& operator=(task const& other) noexcept;
+        TASKS_DLL task& operator=(task&& other) noexcept;
 
         TASKS_DLL virtual void process() = 0;
 
         [[nodiscard]] TASKS_DLL task_state get_current_state() const noexcept;
+        /// <summary>estimated time until the task completes</summary>
+        /// <remarks>
+        /// a running task counts down from its last reported estimate, or from the average of its previous
+        /// runs when it has not reported one; a task which has not started yet returns the estimate reported
+        /// for its next run or failing that the average, and a finished task returns zero. each value is a
+        /// single atomic so reads never tear, though a reader racing the start of a run may briefly see zero
+        /// </remarks>
         [[nodiscard]] TASKS_DLL std::chrono::milliseconds get_estimated_time_remaining() const noexcept;
+        /// <summary>moves a task which is not queued or running to READY</summary>
+        /// <returns>false if the task is already READY or RUNNING</returns>
+        TASKS_DLL bool mark_ready() noexcept;
+        /// <summary>moves the task from expected to desired if it is still in expected</summary>
+        /// <returns>false if the task was not in expected or desired does not follow expected</returns>
+        TASKS_DLL bool transition(task_state const expected, task_state const desired) noexcept;
+
+        [[nodiscard]] TASKS_DLL static bool is_valid_transition(task_state const from, task_state const to) noexcept;
 
     protected:
         TASKS_DLL explicit task() = default;
 
-        TASKS_DLL void update_task_state(task_state const value);
-        TASKS_DLL void update_time_remaining(task_state const value);
+        /// <summary>moves the task from whatever state it is in to value</summary>
+        /// <returns>false if value does not follow the current state</returns>
+        TASKS_DLL bool update_task_state(task_state const value) noexcept;
+        /// <summary>reports the time the task expects to take from now until it completes</summary>
+        /// <remarks>made while the task is not running, value is the estimate for its next run instead</remarks>
+        TASKS_DLL void update_time_remaining(std::chrono::milliseconds const value) noexcept;
 
     private:
-        task_state m_current_state{task_state::PENDING};
-        std::chrono::milliseconds m_time_remaining{};
+        /// <summary>m_started when no run is in progress, either not yet started or claimed by the thread finishing it</summary>
+        static constexpr clock::rep FINISHED_RUN = std::numeric_limits<clock::rep>::min();
+
+        std::atomic<task_state> m_current_state{task_state::PENDING};
+        /// <summary>clock ticks at which a running task is expected to complete</summary>
+        std::atomic<clock::rep> m_expected_completion{};
+        /// <summary>clock ticks at which the current run started</summary>
+        std::atomic<clock::rep> m_started{FINISHED_RUN};
+        /// <summary>clock ticks at which the last run finished, the next one starts strictly after it</summary>
+        std::atomic<clock::rep> m_finished{};
+        /// <summary>moving average of run time in clock ticks, zero until a run has completed</summary>
+        std::atomic<clock::rep> m_average_duration{};
+        /// <summary>run time in clock ticks reported while not running, used in place of the average for the next run</summary>
+        std::atomic<clock::rep> m_next_estimate{};
+
+        void start_run() noexcept;
+        /// <summary>records the run's duration and moves RUNNING to desired, false if another thread finished the run first</summary>
+        bool finish_run(task_state const desired) noexcept;
+
+        static_assert(std::atomic<task_state>::is_always_lock_free);
+        static_assert(std::atomic<clock::rep>::is_always_lock_free);
     };
     
     template <typename TASK>
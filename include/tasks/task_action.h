@@ -15,25 +15,54 @@
 
 #include <chrono>
 #include <future>
+#include <type_traits>
+#include <utility>
+#include <tasks/co_task.h>
 #include <tasks/task_state.h>
 
 namespace tasks
 {
+    /// <summary>state a task_action moves its task to and the estimated time until the task completes</summary>
+    using task_action_result = std::pair<task_state, std::chrono::milliseconds>;
+
     /// <summary>worker method for task, represents a current state and provides process used to transition to the next state (if ready)</summary>
     class task_action
     {
+    public:
+        virtual ~task_action() = default;
+        virtual std::future<task_action_result> process_async() = 0;
+
+    protected:
+        task_action() = default;
         task_action(task_action const&) = default;
         task_action(task_action&&) noexcept = default;
         task_action& operator=(task_action const&) = default;
         task_action& operator=(task_action&&) noexcept = default;
+    };
 
-        virtual ~task_action() = default;
-        virtual std::future<std::pair<task_state, std::chrono::milliseconds>> process_async() = 0;
+    /// <summary>task_action whose process_async is a coroutine, suspending rather than blocking a thread between steps</summary>
+    /// <remarks>
+    /// a step such as waiting for a launched tool to exit can co_await resume_on(pool) once it is ready to
+    /// continue, where a std::future would hold a thread in get and allocate a shared state per step
+    /// </remarks>
+    class co_task_action
+    {
+    public:
+        virtual ~co_task_action() = default;
+        virtual co_task<task_action_result> process_async() = 0;
+
+    protected:
+        co_task_action() = default;
+        co_task_action(co_task_action const&) = default;
+        co_task_action(co_task_action&&) noexcept = default;
+        co_task_action& operator=(co_task_action const&) = default;
+        co_task_action& operator=(co_task_action&&) noexcept = default;
     };
 
     template<typename TASK_ACTION>
     concept TaskAction = requires(TASK_ACTION a) {
-        requires std::is_same<std::future<std::pair<task_state, std::chrono::milliseconds>>, decltype(std::declval<TASK_ACTION>().process_async())>::value;
+        requires std::is_same<std::future<task_action_result>, decltype(a.process_async())>::value ||
+            std::is_same<co_task<task_action_result>, decltype(a.process_async())>::value;
     };
 
     
@@ -13,16 +13,137 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <tasks/task_action.h>
 
 namespace tasks
 {
-    template <Action action>
-    class task_action_factory
+    /// <summary>registers ACTION as the action run by a task in STATE, for use with task_action_factory</summary>
+    template <task_state STATE, TaskAction ACTION>
+    struct task_action_registration final
     {
+        static constexpr task_state state = STATE;
+        using action_type = ACTION;
+    };
+
+    /// <summary>owns one action per registered task_state and dispatches from a state to its action without virtual calls</summary>
+    /// <remarks>
+    /// the mapping from state to action is resolved at compile time; dispatch indexes a constant table built
+    /// per visitor type whose entries call the concrete action directly, so a transition costs one indirect
+    /// jump and no allocation however many tasks share the factory. actions are stored by value in the factory
+    /// </remarks>
+    template <typename... REGISTRATIONS>
+    class task_action_factory final
+    {
+        static constexpr std::size_t STATE_COUNT = static_cast<std::size_t>(task_state::FAILED) + 1;
+        static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+        static constexpr std::array<std::size_t, STATE_COUNT> make_index() noexcept
+        {
+            std::array<std::size_t, STATE_COUNT> index{};
+            index.fill(NONE);
+            std::size_t position{};
+            ((index[static_cast<std::size_t>(REGISTRATIONS::state)] = position++), ...);
+            return index;
+        }
+        static constexpr bool has_unique_states() noexcept
+        {
+            std::array<std::size_t, STATE_COUNT> seen{};
+            ((seen[static_cast<std::size_t>(REGISTRATIONS::state)]++), ...);
+            for (auto const count : seen) {
+                if (count > 1)
+                    return false;
+            }
+            return true;
+        }
+
+        static constexpr auto INDEX = make_index();
+        static_assert(has_unique_states(), "each task_state may be registered once");
+
+        using actions = std::tuple<typename REGISTRATIONS::action_type...>;
+
     public:
-        
+        template <task_state STATE>
+        static constexpr bool contains = INDEX[static_cast<std::size_t>(STATE)] != NONE;
+
+        template <task_state STATE>
+            requires contains<STATE>
+        using action_type = std::tuple_element_t<INDEX[static_cast<std::size_t>(STATE)], actions>;
+
+        [[nodiscard]] static constexpr bool has_action(task_state const state) noexcept
+        {
+            auto const index = static_cast<std::size_t>(state);
+            return index < STATE_COUNT && INDEX[index] != NONE;
+        }
+
+        template <task_state STATE>
+            requires contains<STATE>
+        [[nodiscard]] action_type<STATE>& get() noexcept
+        {
+            return std::get<INDEX[static_cast<std::size_t>(STATE)]>(m_actions);
+        }
+
+        /// <summary>calls visitor with the action registered for state as its concrete type</summary>
+        /// <returns>the visitor's result, the common type of its results across every registered action</returns>
+        /// <exception cref="std::invalid_argument">when no action is registered for state</exception>
+        template <typename VISITOR>
+        decltype(auto) dispatch(task_state const state, VISITOR&& visitor)
+        {
+            using result = std::common_type_t<std::invoke_result_t<VISITOR&, typename REGISTRATIONS::action_type&>...>;
+            static constexpr auto handlers = make_handlers<result, VISITOR>(std::make_index_sequence<STATE_COUNT>());
+
+            auto const index = static_cast<std::size_t>(state);
+            if (index >= STATE_COUNT || handlers[index] == nullptr)
+                throw std::invalid_argument("no action is registered for state");
+            return handlers[index](*this, visitor);
+        }
+        /// <summary>runs process_async on the action registered for state</summary>
+        /// <remarks>requires every registered action to return the same type from process_async</remarks>
+        /// <exception cref="std::invalid_argument">when no action is registered for state</exception>
+        decltype(auto) process_async(task_state const state)
+        {
+            return dispatch(state, [](auto& action) { return action.process_async(); });
+        }
+
+        task_action_factory() = default;
+        /// <param name="actions">one argument per registration, in registration order, to construct each action from</param>
+        /// <remarks>never chosen for another factory, so a single registration factory still copies and moves</remarks>
+        template <typename... ACTIONS>
+            requires (sizeof...(ACTIONS) == sizeof...(REGISTRATIONS) && sizeof...(ACTIONS) != 0 &&
+                (!std::is_same_v<std::remove_cvref_t<ACTIONS>, task_action_factory> && ...))
+        explicit task_action_factory(ACTIONS&&... actions)
+            : m_actions(std::forward<ACTIONS>(actions)...)
+        {
+        }
+
+    private:
+        actions m_actions{};
+
+        template <typename RESULT, typename VISITOR>
+        using handler = RESULT (*)(task_action_factory&, VISITOR&);
+
+        template <typename RESULT, typename VISITOR, std::size_t STATE>
+        static constexpr handler<RESULT, VISITOR> make_handler() noexcept
+        {
+            if constexpr (INDEX[STATE] == NONE) {
+                return nullptr;
+            } else {
+                return [](task_action_factory& factory, VISITOR& visitor) -> RESULT {
+                    return visitor(std::get<INDEX[STATE]>(factory.m_actions));
+                };
+            }
+        }
+        template <typename RESULT, typename VISITOR, std::size_t... STATES>
+        static constexpr std::array<handler<RESULT, VISITOR>, STATE_COUNT> make_handlers(std::index_sequence<STATES...>) noexcept
+        {
+            return {make_handler<RESULT, VISITOR, STATES>()...};
+        }
     };
 
-    
 }
@@ -13,9 +13,13 @@
 
 #pragma once
 
-#ifdef TASKS_DLL_EXPORT
-#   define TASKS_DLL __declspec(dllexport)
+#if defined(_WIN32)
+#   ifdef TASKS_DLL_EXPORT
+#       define TASKS_DLL __declspec(dllexport)
+#   else
+#       define TASKS_DLL __declspec(dllimport)
+#   endif
 #else
-#   define TASKS_DLL __declspec(dllimport)
+#   define TASKS_DLL __attribute__((visibility("default")))
 #endif
 
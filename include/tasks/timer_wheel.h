@@ -0,0 +1,109 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <tasks/task.h>
+#include <tasks/tasks_export.h>
+
+namespace tasks
+{
+    /// <summary>identifies a timer scheduled on a timer_wheel, stale once the timer fires for the last time or is cancelled</summary>
+    struct timer_handle
+    {
+        std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+        std::uint32_t generation{};
+    };
+
+    /// <summary>hierarchical timing wheel which marks tasks ready as they fall due</summary>
+    /// <remarks>
+    /// four levels of 256 slots cover 2^32 ticks, timers further out wait on an overflow list; each slot is
+    /// an intrusive list so scheduling and cancelling are O(1) whatever the number of timers, and as a level
+    /// comes round its slot is redistributed to the level below. advancing skips straight past ticks with
+    /// nothing due. periodic timers are rescheduled from their original schedule rather than from when they
+    /// fired, so they never drift, and firings missed while the wheel was not advanced are skipped rather
+    /// than run back to back. jitter delays each firing by a random amount below it without moving the
+    /// schedule, spreading timers which share a period. not thread safe, one thread advances the wheel and
+    /// hands ready tasks to an executor
+    /// </remarks>
+    class timer_wheel final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        /// <summary>marks work ready at due, then every period after it when period is non-zero</summary>
+        /// <param name="jitter">each firing is delayed by a random duration less than jitter</param>
+        /// <exception cref="std::invalid_argument">when period or jitter is negative</exception>
+        TASKS_DLL timer_handle schedule(task& work, clock::time_point const due, clock::duration const period = clock::duration::zero(), clock::duration const jitter = clock::duration::zero());
+        /// <summary>stops the timer, returning false if it has already fired for the last time or been cancelled</summary>
+        TASKS_DLL bool cancel(timer_handle const handle) noexcept;
+        /// <summary>fires every timer due by now, appending the tasks moved to READY to ready</summary>
+        /// <remarks>tasks which are still READY or RUNNING from an earlier firing are left as they are and not appended</remarks>
+        /// <returns>number of tasks appended</returns>
+        TASKS_DLL std::size_t advance(clock::time_point const now, std::vector<task*>& ready);
+        /// <summary>number of scheduled timers</summary>
+        [[nodiscard]] TASKS_DLL std::size_t size() const noexcept;
+
+        /// <param name="resolution">length of a tick, timers fire on the first tick at or after they are due</param>
+        /// <param name="start">time of tick zero, times before it are treated as due immediately</param>
+        /// <param name="seed">seed for jitter</param>
+        /// <exception cref="std::invalid_argument">when resolution is not positive</exception>
+        TASKS_DLL explicit timer_wheel(clock::duration const resolution = std::chrono::milliseconds(1), clock::time_point const start = clock::now(), std::uint64_t const seed = 0x9E3779B97F4A7C15ULL);
+
+    private:
+        static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+        static constexpr int SLOT_BITS = 8;
+        static constexpr std::size_t SLOTS = 1ULL << SLOT_BITS;
+        static constexpr std::size_t LEVELS = 4;
+        static constexpr std::uint32_t OVERFLOW_BUCKET = LEVELS * SLOTS;
+
+        struct timer
+        {
+            task* work{};
+            /// <summary>tick the timer fires on, its schedule plus jitter rounded up</summary>
+            std::uint64_t due{};
+            /// <summary>time of the current firing since start without jitter, periods are added to this</summary>
+            clock::duration scheduled{};
+            clock::duration period{};
+            clock::duration jitter{};
+            std::uint32_t next{NONE};
+            std::uint32_t previous{NONE};
+            std::uint32_t bucket{NONE};
+            std::uint32_t generation{};
+        };
+
+        clock::duration m_resolution;
+        clock::time_point m_start;
+        std::uint64_t m_random;
+        std::uint64_t m_now{};
+        std::vector<timer> m_timers{};
+        std::uint32_t m_free{NONE};
+        std::size_t m_size{};
+        std::array<std::uint32_t, OVERFLOW_BUCKET + 1> m_buckets{};
+        std::array<std::size_t, LEVELS + 1> m_level_sizes{};
+
+        [[nodiscard]] std::uint64_t to_tick(clock::duration const offset, bool const round_up) const noexcept;
+        [[nodiscard]] std::uint64_t due_tick(timer const& entry) noexcept;
+        void insert(std::uint32_t const index);
+        void unlink(std::uint32_t const index) noexcept;
+        void release(std::uint32_t const index) noexcept;
+        void cascade(std::uint32_t const bucket);
+        [[nodiscard]] std::size_t expire(std::uint32_t const bucket, std::vector<task*>& ready);
+    };
+
+}
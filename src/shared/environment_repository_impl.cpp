@@ -40,6 +40,8 @@ shared_environment_repository make_shared_environment_repository()
     return std::dynamic_pointer_cast<environment_repository>(std::make_shared<environment_repository_impl>());
 }
 
+#ifdef _WIN32
+
 optional<string> environment_repository_impl::get_variable(std::string const& key) const noexcept
 {
     constexpr auto MAX_VARIABLE_NAME_SIZE = 8192;
@@ -61,4 +63,25 @@ bool environment_repository_impl::remove_variable(string const& key) const noexc
 
 }
 
+#else
+
+optional<string> environment_repository_impl::get_variable(std::string const& key) const noexcept
+{
+    auto const* const value = std::getenv(key.c_str());
+    if (value == nullptr || *value == '\0')
+        return nullopt;
+    return optional(string(value));
+}
+bool environment_repository_impl::set_variable(string const& key, string const& value) const noexcept
+{
+    return ::setenv(key.c_str(), value.c_str(), 1) == 0;
+}
+
+bool environment_repository_impl::remove_variable(string const& key) const noexcept
+{
+    return ::unsetenv(key.c_str()) == 0;
+}
+
+#endif
+
 }
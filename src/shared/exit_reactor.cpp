@@ -0,0 +1,226 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#ifdef __linux__
+
+#include "exit_reactor.h"
+#include <array>
+#include <csignal>
+#include <system_error>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+using std::nullopt;
+using std::optional;
+
+using shared::model::exit_future;
+using shared::model::process_key;
+
+namespace
+{
+    constexpr std::uint64_t WAKE_TOKEN = 0ULL;
+    constexpr auto POLL_INTERVAL_MILLISECONDS = 50;
+    constexpr std::size_t MAX_EVENTS = 64;
+
+    [[noreturn]] void throw_last_error(char const* const operation)
+    {
+        throw std::system_error(errno, std::generic_category(), operation);
+    }
+}
+
+namespace shared::infrastructure
+{
+
+exit_future exit_reactor::watch(process_key const& key, bool const reap)
+{
+    std::lock_guard const lock(m_lock);
+    if (auto const existing = m_tokens.find(key); existing != m_tokens.end())
+        return m_watches.at(existing->second).future;
+
+    auto const token = m_next_token++;
+    auto& entry = m_watches[token];
+    entry.key = key;
+    entry.reap = reap;
+    entry.future = entry.exited.get_future().share();
+    m_tokens.emplace(key, token);
+
+    // the pidfd pins the process id, so once it is open a matching start time cannot belong to a reused id
+    entry.process_handle.Reset(static_cast<int>(::syscall(SYS_pidfd_open, key.process_id, 0)));
+    auto future = entry.future;
+    if (optional<unsigned long> exitCode{}; has_exited(entry, exitCode)) {
+        complete(token, exitCode);
+        return future;
+    }
+
+    if (static_cast<bool>(entry.process_handle)) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = token;
+        if (::epoll_ctl(m_epoll.Get(), EPOLL_CTL_ADD, entry.process_handle.Get(), &event) == 0)
+            return future;
+    }
+
+    m_polled.push_back(token);
+    wake();
+    return future;
+}
+
+bool exit_reactor::signal(process_key const& key, int const signal)
+{
+    std::lock_guard const lock(m_lock);
+    auto const token = m_tokens.find(key);
+    if (token == m_tokens.end())
+        return false;
+
+    auto const& entry = m_watches.at(token->second);
+    return static_cast<bool>(entry.process_handle)
+        ? ::syscall(SYS_pidfd_send_signal, entry.process_handle.Get(), signal, nullptr, 0) == 0
+        : ::kill(static_cast<pid_t>(key.process_id), signal) == 0;
+}
+
+std::size_t exit_reactor::size() const
+{
+    std::lock_guard const lock(m_lock);
+    return m_watches.size();
+}
+
+exit_reactor& exit_reactor::instance()
+{
+    static exit_reactor reactor{};
+    return reactor;
+}
+
+exit_reactor::exit_reactor()
+    : m_epoll(::epoll_create1(EPOLL_CLOEXEC))
+    , m_wake(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (!static_cast<bool>(m_epoll) || !static_cast<bool>(m_wake))
+        throw_last_error("exit_reactor");
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_TOKEN;
+    if (::epoll_ctl(m_epoll.Get(), EPOLL_CTL_ADD, m_wake.Get(), &event) != 0)
+        throw_last_error("epoll_ctl");
+
+    m_thread = std::jthread([this](std::stop_token const stop_token) {
+        run(stop_token);
+    });
+}
+
+exit_reactor::~exit_reactor()
+{
+    m_thread.request_stop();
+    wake();
+    if (m_thread.joinable())
+        m_thread.join();
+
+    // anyone still waiting gets an answer rather than a broken promise
+    std::lock_guard const lock(m_lock);
+    for (auto& [token, entry] : m_watches)
+        entry.exited.set_value(nullopt);
+}
+
+void exit_reactor::run(std::stop_token const stop_token)
+{
+    std::array<epoll_event, MAX_EVENTS> events{};
+    while (!stop_token.stop_requested()) {
+        int timeout{};
+        {
+            std::lock_guard const lock(m_lock);
+            timeout = m_polled.empty() ? -1 : POLL_INTERVAL_MILLISECONDS;
+        }
+
+        auto const count = ::epoll_wait(m_epoll.Get(), events.data(), static_cast<int>(events.size()), timeout);
+        if (count < 0 && errno != EINTR)
+            return;
+
+        for (auto i = 0; i < count; i++) {
+            auto const token = events[i].data.u64;
+            if (token == WAKE_TOKEN) {
+                std::uint64_t ignored{};
+                static_cast<void>(::read(m_wake.Get(), &ignored, sizeof(ignored)));
+                continue;
+            }
+
+            std::lock_guard const lock(m_lock);
+            auto const entry = m_watches.find(token);
+            if (optional<unsigned long> exitCode{}; entry != m_watches.end() && has_exited(entry->second, exitCode))
+                complete(token, exitCode);
+        }
+        check_polled();
+    }
+}
+
+void exit_reactor::wake() const noexcept
+{
+    std::uint64_t const signal{1};
+    static_cast<void>(::write(m_wake.Get(), &signal, sizeof(signal)));
+}
+
+void exit_reactor::check_polled()
+{
+    std::lock_guard const lock(m_lock);
+    std::erase_if(m_polled, [this](std::uint64_t const token) {
+        auto const entry = m_watches.find(token);
+        if (entry == m_watches.end())
+            return true;
+
+        optional<unsigned long> exitCode{};
+        if (!has_exited(entry->second, exitCode))
+            return false;
+        complete(token, exitCode);
+        return true;
+    });
+}
+
+void exit_reactor::complete(std::uint64_t const token, optional<unsigned long> const exit_code)
+{
+    // closing the pidfd as the entry is erased also removes it from the epoll set
+    auto const entry = m_watches.find(token);
+    entry->second.exited.set_value(exit_code);
+    m_tokens.erase(entry->second.key);
+    m_watches.erase(entry);
+}
+
+bool exit_reactor::has_exited(watch_entry const& entry, optional<unsigned long>& exit_code)
+{
+    if (entry.reap) {
+        siginfo_t info{};
+        while (::waitid(P_PID, static_cast<id_t>(entry.key.process_id), &info, WEXITED | WNOHANG) < 0) {
+            if (errno != EINTR)
+                return true; // reaped elsewhere, the exit code went with it
+        }
+        if (info.si_pid == 0)
+            return false;
+
+        // follow the shell convention of 128 + signal for processes which were killed
+        exit_code = info.si_code == CLD_EXITED
+            ? static_cast<unsigned long>(info.si_status)
+            : 128UL + static_cast<unsigned long>(info.si_status);
+        return true;
+    }
+
+    auto const stat = m_directory.read_stat(entry.key.process_id);
+    return !stat.has_value() ||
+        (entry.key.start_time != 0ULL && stat.value().start_time != entry.key.start_time) ||
+        stat.value().state == 'Z' || stat.value().state == 'X';
+}
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#ifdef __linux__
+
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "shared/file_descriptor.h"
+#include "shared/process.h"
+#include "shared/process_delta.h"
+#include "shared/shared_export.h"
+#include "proc_directory.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>watches any number of processes for exit from a single thread</summary>
+    /// <remarks>
+    /// each process is opened with pidfd_open and registered with one epoll instance which becomes readable
+    /// as the process exits; kernels without pidfd_open (before 5.3) fall back to the reactor thread
+    /// checking those processes every 50ms, which is still one thread regardless of how many are watched
+    /// </remarks>
+    class exit_reactor final
+    {
+    public:
+        /// <summary>returns a future completed once the process identified by key exits</summary>
+        /// <param name="reap">
+        /// true for children of this process, the reactor then collects the exit status so the future carries
+        /// the exit code; callers must not wait on the child themselves once it is being watched
+        /// </param>
+        /// <remarks>watching the same process twice returns the same future</remarks>
+        [[nodiscard]] SHARED_DLL shared::model::exit_future watch(shared::model::process_key const& key, bool const reap);
+        /// <summary>sends signal to a watched process, returning false if it has already exited</summary>
+        /// <remarks>
+        /// reaping happens under the same lock, so unlike kill(2) the signal cannot reach a process which
+        /// has since been given the same id
+        /// </remarks>
+        SHARED_DLL bool signal(shared::model::process_key const& key, int const signal);
+        [[nodiscard]] SHARED_DLL std::size_t size() const;
+
+        /// <summary>reactor shared by every process object, started on first use</summary>
+        [[nodiscard]] SHARED_DLL static exit_reactor& instance();
+
+        SHARED_DLL exit_reactor();
+        exit_reactor(exit_reactor const&) = delete;
+        exit_reactor& operator=(exit_reactor const&) = delete;
+        exit_reactor(exit_reactor&&) = delete;
+        exit_reactor& operator=(exit_reactor&&) = delete;
+        SHARED_DLL ~exit_reactor();
+
+    private:
+        struct watch_entry
+        {
+            shared::model::process_key key{};
+            bool reap{};
+            file_descriptor process_handle{};
+            std::promise<std::optional<unsigned long>> exited{};
+            shared::model::exit_future future{};
+        };
+
+        mutable std::mutex m_lock{};
+        std::unordered_map<std::uint64_t, watch_entry> m_watches{};
+        std::unordered_map<shared::model::process_key, std::uint64_t> m_tokens{};
+        std::vector<std::uint64_t> m_polled{};
+        std::uint64_t m_next_token{1};
+        file_descriptor m_epoll;
+        file_descriptor m_wake;
+        proc_directory m_directory{};
+        std::jthread m_thread{};
+
+        void run(std::stop_token const stop_token);
+        void wake() const noexcept;
+        void check_polled();
+        void complete(std::uint64_t const token, std::optional<unsigned long> const exit_code);
+        [[nodiscard]] bool has_exited(watch_entry const& entry, std::optional<unsigned long>& exit_code);
+    };
+
+}
+
+#endif
@@ -0,0 +1,43 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "module_path_cache.h"
+
+using std::span;
+
+namespace shared::model
+{
+
+void module_path_cache::apply(span<process_delta const> const deltas)
+{
+    for (auto const& delta : deltas) {
+        if (delta.change == process_change::EXITED)
+            m_paths.erase(delta.key);
+    }
+}
+
+module_path_cache::resolved_path const* module_path_cache::find(process_key const& key) const noexcept
+{
+    auto const cached = m_paths.find(key);
+    return cached != m_paths.end()
+        ? &cached->second
+        : nullptr;
+}
+
+std::size_t module_path_cache::size() const noexcept
+{
+    return m_paths.size();
+}
+
+}
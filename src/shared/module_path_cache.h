@@ -0,0 +1,59 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include "shared/process_delta.h"
+#include "shared/shared_export.h"
+
+namespace shared::model
+{
+    /// <summary>executable path of each process resolved so far, dropped as the process exits</summary>
+    /// <remarks>
+    /// keyed by process id and start time so a reused process id never sees the path of its predecessor;
+    /// failed resolutions are kept as well since access to a process does not change over its lifetime
+    /// </remarks>
+    class module_path_cache final
+    {
+    public:
+        using resolved_path = std::optional<std::filesystem::path>;
+
+        SHARED_DLL void apply(std::span<process_delta const> const deltas);
+
+        /// <summary>returns the cached path of key, calling resolve to fill the cache the first time it is asked for</summary>
+        template <typename RESOLVE>
+        resolved_path const& get(process_key const& key, RESOLVE&& resolve)
+        {
+            if (auto const cached = m_paths.find(key); cached != m_paths.end())
+                return cached->second;
+            return m_paths.emplace(key, resolve(key)).first->second;
+        }
+        [[nodiscard]] SHARED_DLL resolved_path const* find(process_key const& key) const noexcept;
+        [[nodiscard]] SHARED_DLL std::size_t size() const noexcept;
+
+        SHARED_DLL module_path_cache() = default;
+        module_path_cache(module_path_cache const&) = delete;
+        module_path_cache& operator=(module_path_cache const&) = delete;
+        SHARED_DLL module_path_cache(module_path_cache&&) noexcept = default;
+        SHARED_DLL module_path_cache& operator=(module_path_cache&&) noexcept = default;
+        SHARED_DLL ~module_path_cache() = default;
+
+    private:
+        std::unordered_map<process_key, resolved_path> m_paths{};
+    };
+
+}
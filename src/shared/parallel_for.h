@@ -0,0 +1,52 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace shared::infrastructure
+{
+    /// <summary>calls action with every index in [0, count) spread over at most max_workers threads, the caller included</summary>
+    /// <remarks>
+    /// indices are handed out one at a time from a shared counter so a slow item never holds up a fixed
+    /// slice of the others; action must not throw and is expected to write its result by index, which
+    /// keeps results in input order however the work was interleaved
+    /// </remarks>
+    template <typename ACTION>
+    void parallel_for(std::size_t const count, std::size_t const max_workers, ACTION&& action)
+    {
+        std::atomic<std::size_t> next{};
+        auto const run = [&next, count, &action]() {
+            for (auto index = next++; index < count; index = next++)
+                action(index);
+        };
+
+        auto const workers = std::max<std::size_t>(std::min(max_workers, count), 1);
+        std::vector<std::jthread> threads{};
+        threads.reserve(workers - 1);
+        for (std::size_t i = 1; i < workers; i++)
+            threads.emplace_back(run);
+        run();
+    }
+
+    /// <summary>worker bound used by bulk operations, one per hardware thread</summary>
+    [[nodiscard]] inline std::size_t default_worker_count() noexcept
+    {
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+
+}
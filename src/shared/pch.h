@@ -24,10 +24,17 @@
 
 #include "shared/string_extensions.h"
 
-#include <Windows.h>
-#include <sdkddkver.h>
-#include <processthreadsapi.h>
+#ifdef _WIN32
+#   include <Windows.h>
+#   include <sdkddkver.h>
+#   include <processthreadsapi.h>
+
+#   include "shared/invalid_handle.h"
+#   include "shared/null_handle.h"
+#else
+#   include <cstdlib>
+#   include <unistd.h>
+#   include "shared/file_descriptor.h"
+#endif
 
-#include "shared/invalid_handle.h"
-#include "shared/null_handle.h"
 #include "shared/not_found_exception.h"
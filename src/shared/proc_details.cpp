@@ -0,0 +1,111 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "proc_details.h"
+#include <charconv>
+#include <unordered_set>
+
+using std::from_chars;
+using std::nullopt;
+using std::optional;
+using std::string_view;
+using std::vector;
+
+namespace
+{
+    constexpr std::uint64_t BYTES_PER_KILOBYTE = 1024ULL;
+    // address, permissions, offset, device and inode precede the path in each line of maps
+    constexpr auto MAPS_PATH_FIELD = 5;
+
+    [[nodiscard]] string_view next_line(string_view& content) noexcept
+    {
+        auto const length = std::min(content.find('\n'), content.size());
+        auto const line = content.substr(0, length);
+        content.remove_prefix(std::min(length + 1, content.size()));
+        return line;
+    }
+
+    template <typename VALUE>
+    bool parse_field(string_view const line, string_view const name, VALUE& value) noexcept
+    {
+        if (!line.starts_with(name))
+            return false;
+
+        auto number = line.substr(name.size());
+        number.remove_prefix(std::min(number.find_first_not_of(" \t"), number.size()));
+        return from_chars(number.data(), number.data() + number.size(), value).ec == std::errc();
+    }
+}
+
+namespace shared::infrastructure
+{
+
+optional<proc_status> parse_proc_status(string_view content) noexcept
+{
+    proc_status status{};
+    bool threadsFound{};
+    while (!content.empty()) {
+        auto const line = next_line(content);
+        if (parse_field(line, "Threads:", status.thread_count))
+            threadsFound = true;
+        else if (parse_field(line, "VmRSS:", status.resident_bytes))
+            status.resident_bytes *= BYTES_PER_KILOBYTE;
+        else if (parse_field(line, "RssAnon:", status.anonymous_bytes))
+            status.anonymous_bytes *= BYTES_PER_KILOBYTE;
+    }
+
+    return threadsFound
+        ? optional(status)
+        : nullopt;
+}
+
+optional<proc_statm> parse_proc_statm(string_view content) noexcept
+{
+    proc_statm statm{};
+    for (auto* const field : {&statm.size_pages, &statm.resident_pages, &statm.shared_pages}) {
+        content.remove_prefix(std::min(content.find_first_not_of(' '), content.size()));
+        auto const [end, error] = from_chars(content.data(), content.data() + content.size(), *field);
+        if (error != std::errc())
+            return nullopt;
+        content.remove_prefix(static_cast<std::size_t>(end - content.data()));
+    }
+    return optional(statm);
+}
+
+vector<std::filesystem::path> parse_proc_maps_modules(string_view content)
+{
+    vector<std::filesystem::path> modules{};
+    std::unordered_set<string_view> seen{};
+    while (!content.empty()) {
+        auto line = next_line(content);
+
+        auto field = 0;
+        auto executable = false;
+        while (field < MAPS_PATH_FIELD && !line.empty()) {
+            auto const length = std::min(line.find(' '), line.size());
+            if (field == 1)
+                executable = length >= 3 && line[2] == 'x';
+            line.remove_prefix(length);
+            line.remove_prefix(std::min(line.find_first_not_of(' '), line.size()));
+            field++;
+        }
+
+        // anonymous and pseudo mappings such as [vdso] have no path
+        if (executable && line.starts_with('/') && seen.insert(line).second)
+            modules.emplace_back(line);
+    }
+    return modules;
+}
+
+}
@@ -0,0 +1,50 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "shared/shared_export.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>the fields of /proc/[pid]/status used to fill process_details</summary>
+    struct proc_status
+    {
+        unsigned long thread_count{};
+        std::uint64_t resident_bytes{};
+        std::uint64_t anonymous_bytes{};
+    };
+
+    /// <summary>the leading fields of /proc/[pid]/statm, in pages</summary>
+    struct proc_statm
+    {
+        std::uint64_t size_pages{};
+        std::uint64_t resident_pages{};
+        std::uint64_t shared_pages{};
+    };
+
+    /// <summary>parses the content of /proc/[pid]/status, kernel threads have no memory lines and report zero</summary>
+    [[nodiscard]] SHARED_DLL std::optional<proc_status> parse_proc_status(std::string_view const content) noexcept;
+
+    /// <summary>parses the content of /proc/[pid]/statm</summary>
+    [[nodiscard]] SHARED_DLL std::optional<proc_statm> parse_proc_statm(std::string_view const content) noexcept;
+
+    /// <summary>returns the distinct files mapped executable in the content of /proc/[pid]/maps, in order of first mapping</summary>
+    [[nodiscard]] SHARED_DLL std::vector<std::filesystem::path> parse_proc_maps_modules(std::string_view const content);
+
+}
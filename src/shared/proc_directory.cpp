@@ -0,0 +1,252 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#ifdef __linux__
+
+#include "proc_directory.h"
+#include <cerrno>
+#include <charconv>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+
+using std::nullopt;
+using std::optional;
+using std::string_view;
+
+using shared::model::process_key;
+using shared::model::resource_sample;
+
+namespace
+{
+    // getdents64 has no glibc wrapper before 2.30 so the record layout is declared here as documented in getdents(2)
+    struct linux_dirent64
+    {
+        ino64_t d_ino;
+        off64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[];
+    };
+
+    constexpr std::size_t DIRECTORY_BUFFER_SIZE = 64 * 1024;
+    constexpr std::size_t DESCRIPTOR_BUFFER_SIZE = 16 * 1024;
+    constexpr std::size_t STAT_BUFFER_SIZE = 1024;
+    constexpr std::size_t STATM_BUFFER_SIZE = 256;
+    constexpr std::size_t STAT_PATH_SIZE = 32;
+}
+
+namespace shared::infrastructure
+{
+
+proc_directory::proc_directory(char const* const root)
+    : m_directory(::open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC))
+    , m_buffer(DIRECTORY_BUFFER_SIZE)
+{
+    if (!static_cast<bool>(m_directory))
+        throw std::runtime_error(std::string("unable to open ") + root);
+}
+
+bool proc_directory::read_next(proc_stat& stat)
+{
+    while (true) {
+        if (m_offset >= m_length && !fill_buffer())
+            return false;
+
+        auto const* const entry = reinterpret_cast<linux_dirent64 const*>(&m_buffer[m_offset]);
+        m_offset += entry->d_reclen;
+
+        if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+            continue;
+
+        auto const processId = parse_process_id(string_view(entry->d_name));
+        if (!processId.has_value())
+            continue;
+
+        if (auto const current = read_stat(processId.value()); current.has_value()) {
+            stat = current.value();
+            return true;
+        }
+    }
+}
+
+void proc_directory::rewind() noexcept
+{
+    ::lseek(m_directory.Get(), 0, SEEK_SET);
+    m_offset = 0;
+    m_length = 0;
+}
+
+optional<proc_stat> proc_directory::read_stat(unsigned long const process_id) const noexcept
+{
+    file_descriptor const file(open_process_file(process_id, "/stat", O_RDONLY));
+    if (!static_cast<bool>(file))
+        return nullopt;
+
+    char content[STAT_BUFFER_SIZE];
+    auto const length = ::read(file.Get(), content, STAT_BUFFER_SIZE);
+    if (length <= 0)
+        return nullopt;
+
+    return parse_proc_stat(string_view(content, static_cast<std::size_t>(length)));
+}
+
+optional<proc_statm> proc_directory::read_statm(unsigned long const process_id) const noexcept
+{
+    file_descriptor const file(open_process_file(process_id, "/statm", O_RDONLY));
+    if (!static_cast<bool>(file))
+        return nullopt;
+
+    char content[STATM_BUFFER_SIZE];
+    auto const length = ::read(file.Get(), content, STATM_BUFFER_SIZE);
+    if (length <= 0)
+        return nullopt;
+
+    return parse_proc_statm(string_view(content, static_cast<std::size_t>(length)));
+}
+
+optional<unsigned long> proc_directory::count_descriptors(unsigned long const process_id)
+{
+    file_descriptor const directory(open_process_file(process_id, "/fd", O_RDONLY | O_DIRECTORY));
+    if (!static_cast<bool>(directory))
+        return nullopt;
+
+    if (m_descriptor_buffer.empty())
+        m_descriptor_buffer.resize(DESCRIPTOR_BUFFER_SIZE);
+
+    unsigned long count{};
+    for (;;) {
+        auto const length = ::syscall(SYS_getdents64, directory.Get(), m_descriptor_buffer.data(), m_descriptor_buffer.size());
+        if (length < 0)
+            return nullopt;
+        if (length == 0)
+            return optional(count);
+
+        for (std::size_t offset = 0; offset < static_cast<std::size_t>(length);) {
+            auto const* const entry = reinterpret_cast<linux_dirent64 const*>(&m_descriptor_buffer[offset]);
+            offset += entry->d_reclen;
+            if (entry->d_name[0] != '.')
+                count++;
+        }
+    }
+}
+
+bool proc_directory::fill_buffer()
+{
+    auto const length = ::syscall(SYS_getdents64, m_directory.Get(), m_buffer.data(), m_buffer.size());
+    if (length <= 0)
+        return false;
+
+    m_offset = 0;
+    m_length = static_cast<std::size_t>(length);
+    return true;
+}
+
+file_descriptor proc_directory::open_process_file(unsigned long const process_id, string_view const name, int const flags) const noexcept
+{
+    char path[STAT_PATH_SIZE]{};
+    auto const [end, error] = std::to_chars(path, path + STAT_PATH_SIZE - name.size() - 1, process_id);
+    if (error != std::errc())
+        return file_descriptor();
+    name.copy(end, name.size());
+
+    return file_descriptor(::openat(m_directory.Get(), path, flags | O_CLOEXEC));
+}
+
+unique_process_entry_reader make_process_entry_reader()
+{
+    return std::make_unique<proc_entry_reader>();
+}
+
+void proc_entry_reader::rewind()
+{
+    m_directory.rewind();
+}
+
+bool proc_entry_reader::read_next(process_entry& entry)
+{
+    if (!m_directory.read_next(m_current))
+        return false;
+
+    entry.process_id = m_current.process_id;
+    entry.parent_process_id = m_current.parent_process_id;
+    entry.start_time = m_current.start_time;
+    entry.thread_count = m_current.thread_count;
+    entry.name = m_current.name();
+    return true;
+}
+
+unique_resource_reader make_resource_reader()
+{
+    return std::make_unique<proc_resource_reader>();
+}
+
+proc_resource_reader::proc_resource_reader()
+    : m_ticks_per_second(static_cast<std::uint64_t>(::sysconf(_SC_CLK_TCK)))
+    , m_page_size(static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE)))
+{
+}
+
+void proc_resource_reader::begin_round()
+{
+    // every counter is read per process on linux
+}
+
+optional<unsigned long long> proc_resource_reader::get_start_time(unsigned long const process_id)
+{
+    auto const stat = m_directory.read_stat(process_id);
+    return stat.has_value()
+        ? optional(stat.value().start_time)
+        : nullopt;
+}
+
+read_result proc_resource_reader::read(process_key const& key, resource_sample& sample)
+{
+    // /proc/[pid] is gone (ENOENT) or a read races the exit (ESRCH) once the process has exited, anything
+    // else such as EACCES or a short read may succeed next round
+    errno = 0;
+    auto const stat = m_directory.read_stat(key.process_id);
+    if (!stat.has_value())
+        return errno == ENOENT || errno == ESRCH ? read_result::EXITED : read_result::UNAVAILABLE;
+    if (stat.value().start_time != key.start_time || stat.value().state == 'Z' || stat.value().state == 'X')
+        return read_result::EXITED;
+
+    auto const toNanoseconds = [this](unsigned long long const ticks) {
+        return std::chrono::nanoseconds(ticks * 1'000'000'000ULL / m_ticks_per_second);
+    };
+    sample.user_time = toNanoseconds(stat.value().user_time);
+    sample.system_time = toNanoseconds(stat.value().system_time);
+    sample.thread_count = stat.value().thread_count;
+
+    if (auto const statm = m_directory.read_statm(key.process_id); statm.has_value()) {
+        sample.resident_bytes = statm.value().resident_pages * m_page_size;
+        sample.private_bytes = (statm.value().resident_pages - std::min(statm.value().shared_pages, statm.value().resident_pages)) * m_page_size;
+    }
+    sample.handle_count = m_directory.count_descriptors(key.process_id).value_or(0UL);
+    return read_result::SAMPLED;
+}
+
+optional<unsigned long> parse_process_id(string_view const name) noexcept
+{
+    unsigned long processId{};
+    auto const [end, error] = std::from_chars(name.data(), name.data() + name.size(), processId);
+    return !name.empty() && error == std::errc() && end == name.data() + name.size()
+        ? optional(processId)
+        : nullopt;
+}
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#ifdef __linux__
+
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "shared/file_descriptor.h"
+#include "shared/shared_export.h"
+#include "proc_details.h"
+#include "proc_stat.h"
+#include "process_entry.h"
+#include "resource_reader.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>forward only reader over the process entries of /proc</summary>
+    /// <remarks>
+    /// directory entries are read with getdents64 into a buffer which is kept between scans and each
+    /// /proc/[pid]/stat is read into a stack buffer relative to the open directory, so walking the
+    /// process list allocates nothing once the buffer has grown to fit a batch of entries
+    /// </remarks>
+    class proc_directory final
+    {
+    public:
+        /// <summary>reads the next process entry, returning false once every entry has been read</summary>
+        /// <remarks>processes which exit between listing the directory and reading their stat are skipped</remarks>
+        [[nodiscard]] SHARED_DLL bool read_next(proc_stat& stat);
+        /// <summary>restarts the scan from the first entry, picking up processes started since the last scan</summary>
+        SHARED_DLL void rewind() noexcept;
+
+        [[nodiscard]] SHARED_DLL std::optional<proc_stat> read_stat(unsigned long const process_id) const noexcept;
+        [[nodiscard]] SHARED_DLL std::optional<proc_statm> read_statm(unsigned long const process_id) const noexcept;
+        /// <summary>counts the entries of /proc/[pid]/fd, which is only readable for processes of the same user</summary>
+        [[nodiscard]] SHARED_DLL std::optional<unsigned long> count_descriptors(unsigned long const process_id);
+
+        SHARED_DLL explicit proc_directory(char const* const root = "/proc");
+        proc_directory(proc_directory const&) = delete;
+        proc_directory& operator=(proc_directory const&) = delete;
+        SHARED_DLL proc_directory(proc_directory&&) noexcept = default;
+        SHARED_DLL proc_directory& operator=(proc_directory&&) noexcept = default;
+        SHARED_DLL ~proc_directory() = default;
+
+    private:
+        file_descriptor m_directory;
+        std::vector<char> m_buffer;
+        std::size_t m_offset{};
+        std::size_t m_length{};
+        std::vector<char> m_descriptor_buffer{};
+
+        [[nodiscard]] bool fill_buffer();
+        [[nodiscard]] file_descriptor open_process_file(unsigned long const process_id, std::string_view const name, int const flags) const noexcept;
+    };
+
+    /// <summary>process_entry_reader over proc_directory, entry names refer to comm of the most recently read stat</summary>
+    class proc_entry_reader final : public process_entry_reader
+    {
+    public:
+        void rewind() override;
+        [[nodiscard]] bool read_next(process_entry& entry) override;
+
+    private:
+        proc_directory m_directory{};
+        proc_stat m_current{};
+    };
+
+    /// <summary>resource_reader over /proc/[pid]/stat, statm and fd, reading into buffers which are reused between rounds</summary>
+    class proc_resource_reader final : public resource_reader
+    {
+    public:
+        void begin_round() override;
+        [[nodiscard]] std::optional<unsigned long long> get_start_time(unsigned long const process_id) override;
+        [[nodiscard]] read_result read(shared::model::process_key const& key, shared::model::resource_sample& sample) override;
+
+        proc_resource_reader();
+
+    private:
+        proc_directory m_directory{};
+        std::uint64_t m_ticks_per_second;
+        std::uint64_t m_page_size;
+    };
+
+    /// <summary>parses a /proc directory entry name, returning the process id for numeric names</summary>
+    [[nodiscard]] SHARED_DLL std::optional<unsigned long> parse_process_id(std::string_view const name) noexcept;
+
+}
+
+#endif
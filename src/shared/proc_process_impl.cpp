@@ -0,0 +1,456 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#ifdef __linux__
+
+#include "proc_process_impl.h"
+#include "exit_reactor.h"
+#include "proc_details.h"
+#include "process_name_index.h"
+#include <chrono>
+#include <thread>
+#include <climits>
+#include <fcntl.h>
+#include <csignal>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+
+extern char** environ;
+
+using std::nullopt;
+using std::optional;
+using std::span;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using shared::infrastructure::exit_reactor;
+using shared::infrastructure::file_descriptor;
+using shared::infrastructure::parse_proc_maps_modules;
+using shared::infrastructure::parse_proc_status;
+using shared::infrastructure::proc_directory;
+using shared::infrastructure::proc_stat;
+using shared::model::unique_process;
+
+namespace
+{
+    constexpr auto EXIT_POLL_INTERVAL = std::chrono::milliseconds(50);
+
+    [[nodiscard]] shared::model::exit_future make_ready_exit_future(optional<unsigned long> const exit_code)
+    {
+        std::promise<optional<unsigned long>> exited{};
+        exited.set_value(exit_code);
+        return exited.get_future().share();
+    }
+
+    [[nodiscard]] optional<string> read_text(string const& filename)
+    {
+        file_descriptor const file(::open(filename.c_str(), O_RDONLY | O_CLOEXEC));
+        if (!static_cast<bool>(file))
+            return nullopt;
+
+        // proc files report a size of zero so they can only be read until read returns nothing
+        string content(4096, '\0');
+        std::size_t length{};
+        for (;;) {
+            auto const count = ::read(file.Get(), content.data() + length, content.size() - length);
+            if (count < 0) {
+                if (errno == EINTR)
+                    continue;
+                return nullopt;
+            }
+            if (count == 0)
+                break;
+            length += static_cast<std::size_t>(count);
+            if (length == content.size())
+                content.resize(content.size() * 2);
+        }
+        content.resize(length);
+        return optional(std::move(content));
+    }
+
+    /// <summary>owns a posix_spawn_file_actions_t, used to connect the standard streams of a child to pipes</summary>
+    class spawn_file_actions final
+    {
+    public:
+        /// <summary>creates a pipe whose write end replaces target in the child, both ends close on exec in the parent</summary>
+        [[nodiscard]] bool redirect(int const target, file_descriptor& read_end, file_descriptor& write_end) noexcept
+        {
+            int ends[2]{};
+            if (::pipe2(ends, O_CLOEXEC) != 0)
+                return false;
+            read_end.Reset(ends[0]);
+            write_end.Reset(ends[1]);
+            return posix_spawn_file_actions_adddup2(&m_actions, write_end.Get(), target) == 0;
+        }
+        [[nodiscard]] posix_spawn_file_actions_t const* get() const noexcept
+        {
+            return &m_actions;
+        }
+
+        spawn_file_actions() noexcept
+        {
+            posix_spawn_file_actions_init(&m_actions);
+        }
+        spawn_file_actions(spawn_file_actions const&) = delete;
+        spawn_file_actions& operator=(spawn_file_actions const&) = delete;
+        spawn_file_actions(spawn_file_actions&&) = delete;
+        spawn_file_actions& operator=(spawn_file_actions&&) = delete;
+        ~spawn_file_actions()
+        {
+            posix_spawn_file_actions_destroy(&m_actions);
+        }
+
+    private:
+        posix_spawn_file_actions_t m_actions{};
+    };
+}
+
+namespace shared::model
+{
+
+unique_process proc_process_impl::start(string_view const& filename, string_view const& arguments, process_ownership const ownership)
+{
+    process_start_info startInfo{};
+    startInfo.filename = filename;
+    startInfo.arguments = split_arguments(arguments);
+    startInfo.ownership = ownership;
+    return start(startInfo);
+}
+
+unique_process proc_process_impl::start(process_start_info const& start_info)
+{
+    auto const absolutePath = std::filesystem::absolute(start_info.filename).string();
+
+    if (!std::filesystem::exists(absolutePath) || !std::filesystem::is_regular_file(absolutePath))
+        throw std::invalid_argument("file not found");
+
+    // posix_spawn takes non const pointers for historical reasons but never writes through them
+    vector<char*> argv{};
+    argv.reserve(start_info.arguments.size() + 2);
+    argv.push_back(const_cast<char*>(absolutePath.c_str()));
+    for (auto const& argument : start_info.arguments)
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+
+    vector<char*> environment{};
+    if (start_info.environment.has_value()) {
+        environment.reserve(start_info.environment.value().size() + 1);
+        for (auto const& variable : start_info.environment.value())
+            environment.push_back(const_cast<char*>(variable.c_str()));
+        environment.push_back(nullptr);
+    }
+
+    spawn_file_actions actions{};
+    file_descriptor standardOutput{};
+    file_descriptor standardError{};
+    file_descriptor childOutput{};
+    file_descriptor childError{};
+    if (start_info.redirect_standard_output && !actions.redirect(STDOUT_FILENO, standardOutput, childOutput))
+        return unique_process();
+    if (start_info.redirect_standard_error && !actions.redirect(STDERR_FILENO, standardError, childError))
+        return unique_process();
+
+    pid_t processId{};
+    if (posix_spawn(&processId, absolutePath.c_str(), actions.get(), nullptr, argv.data(),
+        start_info.environment.has_value() ? environment.data() : environ) != 0)
+        return unique_process();
+
+    // make_unique won't work unless we do some trickery to make it a friend function, the write ends close
+    // here as they go out of scope so reads see end of stream once the child exits
+    return unique_process(new proc_process_impl(static_cast<int>(processId), start_info.ownership, std::move(standardOutput), std::move(standardError)));
+}
+
+unique_process proc_process_impl::open(process_key const& key)
+{
+    return unique_process(new proc_process_impl(key.process_id, key.start_time));
+}
+
+unsigned long proc_process_impl::get_id() const noexcept
+{
+    return m_process_id;
+}
+
+bool proc_process_impl::is_running() const noexcept
+{
+    if (m_process_id == 0UL)
+        return false;
+
+    if (m_process_launched)
+        return m_exited.valid() && m_exited.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+
+    auto const stat = get_proc_directory().read_stat(m_process_id);
+    return stat.has_value() &&
+        stat.value().start_time == m_start_time &&
+        stat.value().state != 'Z' && stat.value().state != 'X';
+}
+
+optional<unsigned long> proc_process_impl::exit_code() const noexcept
+{
+    // only a parent can collect the exit status of a process on linux
+    if (!m_process_launched || is_running())
+        return nullopt;
+    return launched_exit_code();
+}
+
+void proc_process_impl::wait_for_exit() const noexcept
+{
+    if (!is_running())
+        return;
+
+    if (m_process_launched) {
+        m_exited.wait();
+        return;
+    }
+
+    if (file_descriptor const processHandle(static_cast<int>(::syscall(SYS_pidfd_open, m_process_id, 0)));
+        static_cast<bool>(processHandle)) {
+        pollfd request{processHandle.Get(), POLLIN, 0};
+        while (::poll(&request, 1, -1) < 0 && errno == EINTR) {
+        }
+        return;
+    }
+
+    // pidfd_open is unavailable before 5.3 so fall back to polling
+    while (is_running())
+        std::this_thread::sleep_for(EXIT_POLL_INTERVAL);
+}
+
+exit_future proc_process_impl::when_exited() const
+{
+    // a launched process has watched itself since construction, only the first wait on any other writes m_exited
+    if (m_process_launched)
+        return m_exited.valid() ? m_exited : make_ready_exit_future(nullopt);
+
+    std::lock_guard const lock(m_exited_lock);
+    if (m_exited.valid())
+        return m_exited;
+    if (!is_running())
+        return make_ready_exit_future(nullopt);
+
+    m_exited = exit_reactor::instance().watch({m_process_id, m_start_time}, false);
+    return m_exited;
+}
+
+std::size_t proc_process_impl::read_standard_output(span<char> const buffer) const noexcept
+{
+    return read_stream(m_standard_output, buffer);
+}
+
+std::size_t proc_process_impl::read_standard_error(span<char> const buffer) const noexcept
+{
+    return read_stream(m_standard_error, buffer);
+}
+
+optional<std::filesystem::path> proc_process_impl::get_path_to_running_process(string_view const& process_name) const noexcept
+{
+    try {
+        auto const process = get_process_by_name(process_name);
+        if (!process.has_value())
+            return nullopt;
+
+        return get_executable_path({process.value().process_id, process.value().start_time});
+    } catch (std::exception const&) {
+        return nullopt;
+    }
+}
+
+proc_process_impl::proc_process_impl(unsigned long const process_id, unsigned long long const start_time)
+    : m_process_id(process_id)
+    , m_start_time(start_time)
+{
+}
+
+proc_process_impl::proc_process_impl(int const child_process_id, process_ownership const ownership,
+    file_descriptor standard_output, file_descriptor standard_error)
+    : m_process_launched(true)
+    , m_process_id(static_cast<unsigned long>(child_process_id))
+    , m_ownership(ownership)
+    , m_standard_output(std::move(standard_output))
+    , m_standard_error(std::move(standard_error))
+{
+    if (auto const stat = get_proc_directory().read_stat(m_process_id); stat.has_value())
+        m_start_time = stat.value().start_time;
+    m_exited = exit_reactor::instance().watch({m_process_id, m_start_time}, true);
+}
+
+proc_process_impl::proc_process_impl(proc_process_impl&& other) noexcept
+    : m_process_launched{other.m_process_launched}
+    , m_process_id{other.m_process_id}
+    , m_start_time{other.m_start_time}
+    , m_ownership{other.m_ownership}
+    , m_exited{std::move(other.m_exited)}
+    , m_standard_output{std::move(other.m_standard_output)}
+    , m_standard_error{std::move(other.m_standard_error)}
+{
+    other.m_process_id = 0UL;
+    other.m_start_time = 0ULL;
+    other.m_process_launched = false;
+}
+
+proc_process_impl& proc_process_impl::operator=(proc_process_impl&& other) noexcept
+{
+    std::swap(m_process_launched, other.m_process_launched);
+    std::swap(m_process_id, other.m_process_id);
+    std::swap(m_start_time, other.m_start_time);
+    std::swap(m_ownership, other.m_ownership);
+    std::swap(m_exited, other.m_exited);
+    swap(m_standard_output, other.m_standard_output);
+    swap(m_standard_error, other.m_standard_error);
+    return *this;
+}
+
+proc_process_impl::~proc_process_impl()
+{
+    // never wait here, the reactor goes on to reap the process whichever way it ends
+    if (m_process_launched && m_ownership == process_ownership::KILL_ON_DROP)
+        static_cast<void>(exit_reactor::instance().signal({m_process_id, m_start_time}, SIGKILL));
+    m_process_launched = false;
+    m_process_id = 0UL;
+    m_start_time = 0ULL;
+}
+
+bool proc_process_impl::equals(proc_process_impl const& other) const noexcept
+{
+    return m_process_id == other.m_process_id &&
+        m_start_time == other.m_start_time;
+}
+
+vector<string> proc_process_impl::split_arguments(string_view const& arguments)
+{
+    vector<string> values{};
+    string current{};
+    bool quoted{};
+    bool pending{};
+
+    for (auto const value : arguments) {
+        if (value == '"') {
+            quoted = !quoted;
+            pending = true;
+        } else if (!quoted && (value == ' ' || value == '\t')) {
+            if (pending)
+                values.push_back(std::move(current));
+            current.clear();
+            pending = false;
+        } else {
+            current.push_back(value);
+            pending = true;
+        }
+    }
+    if (pending)
+        values.push_back(std::move(current));
+    return values;
+}
+
+std::size_t proc_process_impl::read_stream(file_descriptor const& stream, span<char> const buffer) noexcept
+{
+    if (!static_cast<bool>(stream) || buffer.empty())
+        return 0;
+
+    for (;;) {
+        if (auto const count = ::read(stream.Get(), buffer.data(), buffer.size()); count >= 0)
+            return static_cast<std::size_t>(count);
+        if (errno != EINTR)
+            return 0;
+    }
+}
+
+optional<unsigned long> proc_process_impl::launched_exit_code() const noexcept
+{
+    try {
+        return m_exited.valid()
+            ? m_exited.get()
+            : nullopt;
+    }
+    catch (std::exception const&) {
+        return nullopt;
+    }
+}
+
+proc_directory& proc_process_impl::get_proc_directory()
+{
+    // one reader per thread so the getdents64 buffer is reused between scans without locking
+    thread_local proc_directory directory{};
+    return directory;
+}
+
+optional<proc_stat> proc_process_impl::get_process_by_name(string_view const& process_name)
+{
+    auto& directory = get_proc_directory();
+    directory.rewind();
+
+    proc_stat entry{};
+    while (directory.read_next(entry)) {
+        if (process_name_index::matches(process_name, entry.name(), MAX_NAME_LENGTH))
+            return optional(entry);
+    }
+    return nullopt;
+}
+
+optional<std::filesystem::path> proc_process_impl::get_executable_path(process_key const& key)
+{
+    auto const link = "/proc/" + std::to_string(key.process_id) + "/exe";
+    char target[PATH_MAX];
+    auto const length = ::readlink(link.c_str(), target, sizeof(target));
+    if (length <= 0)
+        return nullopt;
+
+    // checked after the read so a process id reused in between cannot hand back the wrong path
+    if (auto const stat = get_proc_directory().read_stat(key.process_id);
+        !stat.has_value() || stat.value().start_time != key.start_time)
+        return nullopt;
+    return optional(std::filesystem::path(string(target, static_cast<std::size_t>(length))));
+}
+
+bool proc_process_impl::collect_details(process_key const& key, process_details& details)
+{
+    auto const directory = "/proc/" + std::to_string(key.process_id);
+    auto const status = read_text(directory + "/status");
+    auto const maps = read_text(directory + "/maps");
+    if (!status.has_value() || !maps.has_value())
+        return false;
+
+    auto const parsed = parse_proc_status(status.value());
+    if (!parsed.has_value())
+        return false;
+
+    // checked after reading so that details of a process which replaced key under the same id are discarded
+    if (auto const stat = get_proc_directory().read_stat(key.process_id);
+        !stat.has_value() || stat.value().start_time != key.start_time)
+        return false;
+
+    details.thread_count = parsed.value().thread_count;
+    details.resident_bytes = parsed.value().resident_bytes;
+    details.private_bytes = parsed.value().anonymous_bytes;
+    details.modules = parse_proc_maps_modules(maps.value());
+
+    // maps lists images in address order, move the main executable to the front as toolhelp does
+    if (auto const executable = get_executable_path(key); executable.has_value()) {
+        if (auto const position = std::find(begin(details.modules), end(details.modules), executable.value());
+            position != end(details.modules))
+            std::rotate(begin(details.modules), position, position + 1);
+    }
+    return true;
+}
+
+bool operator==(proc_process_impl const& left_hand_side, proc_process_impl const& right_hand_side)
+{
+    return &left_hand_side == &right_hand_side || left_hand_side.equals(right_hand_side);
+}
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#ifdef __linux__
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include "shared/process.h"
+#include "shared/process_delta.h"
+#include "shared/process_details.h"
+#include "shared/process_start_info.h"
+#include "proc_directory.h"
+
+namespace shared::model
+{
+    /// <summary>linux implementation of process backed by /proc, the counterpart of process_impl</summary>
+    class proc_process_impl final : public process
+    {
+    public:
+        static unique_process start(std::string_view const& filename, std::string_view const& arguments, process_ownership const ownership);
+        /// <summary>launches through posix_spawn, which glibc implements with a vfork style clone so no page tables are copied</summary>
+        static unique_process start(process_start_info const& start_info);
+        static unique_process open(process_key const& key);
+        /// <summary>resolves the executable of key through /proc/[pid]/exe</summary>
+        static std::optional<std::filesystem::path> get_executable_path(process_key const& key);
+        /// <summary>fills details from /proc/[pid]/status and maps, returning false if key is no longer running</summary>
+        static bool collect_details(process_key const& key, process_details& details);
+
+        /// <summary>comm is truncated to 15 characters, longer names can only be matched by that prefix</summary>
+        static constexpr std::size_t MAX_NAME_LENGTH = shared::infrastructure::proc_stat::MAX_COMM_LENGTH - 1;
+
+        [[nodiscard]] unsigned long get_id() const noexcept final;
+        [[nodiscard]] bool is_running() const noexcept final;
+        [[nodiscard]] std::optional<unsigned long> exit_code() const noexcept final;
+        void wait_for_exit() const noexcept final;
+        [[nodiscard]] exit_future when_exited() const final;
+        [[nodiscard]] std::size_t read_standard_output(std::span<char> const buffer) const noexcept final;
+        [[nodiscard]] std::size_t read_standard_error(std::span<char> const buffer) const noexcept final;
+        [[nodiscard]] std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& process_name) const noexcept final;
+
+        proc_process_impl() = default;
+        explicit proc_process_impl(unsigned long const process_id, unsigned long long const start_time);
+        proc_process_impl(const proc_process_impl&) = delete;
+        proc_process_impl& operator=(const proc_process_impl&) = delete;
+        proc_process_impl(proc_process_impl&& other) noexcept;
+        proc_process_impl& operator=(proc_process_impl&& other) noexcept;
+        ~proc_process_impl();
+
+        [[nodiscard]] bool equals(proc_process_impl const& other) const noexcept;
+
+        [[nodiscard]] static std::vector<std::string> split_arguments(std::string_view const& arguments);
+
+    private:
+        bool m_process_launched{};
+        unsigned long m_process_id{};
+        unsigned long long m_start_time{};
+        process_ownership m_ownership{process_ownership::DETACH};
+        // launched processes are reaped by the exit reactor from the moment they start, so a process
+        // which is dropped never lingers as a zombie and its exit code is read from here
+        mutable exit_future m_exited{};
+        /// <summary>guards the watch when_exited creates on first use for a process this one did not launch</summary>
+        mutable std::mutex m_exited_lock{};
+        shared::infrastructure::file_descriptor m_standard_output{};
+        shared::infrastructure::file_descriptor m_standard_error{};
+
+        explicit proc_process_impl(int const child_process_id, process_ownership const ownership,
+            shared::infrastructure::file_descriptor standard_output, shared::infrastructure::file_descriptor standard_error);
+        [[nodiscard]] static std::size_t read_stream(shared::infrastructure::file_descriptor const& stream, std::span<char> const buffer) noexcept;
+        [[nodiscard]] std::optional<unsigned long> launched_exit_code() const noexcept;
+
+        static shared::infrastructure::proc_directory& get_proc_directory();
+        static std::optional<shared::infrastructure::proc_stat> get_process_by_name(std::string_view const& process_name);
+    };
+
+    bool operator==(proc_process_impl const& left_hand_side, proc_process_impl const& right_hand_side);
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "proc_stat.h"
+#include <charconv>
+
+using std::from_chars;
+using std::nullopt;
+using std::optional;
+using std::string_view;
+
+namespace
+{
+    // field numbers as documented in proc(5), counted from the state field which follows comm
+    constexpr auto STATE_FIELD = 3;
+    constexpr auto PARENT_PROCESS_ID_FIELD = 4;
+    constexpr auto USER_TIME_FIELD = 14;
+    constexpr auto SYSTEM_TIME_FIELD = 15;
+    constexpr auto THREAD_COUNT_FIELD = 20;
+    constexpr auto START_TIME_FIELD = 22;
+    constexpr auto RESIDENT_PAGES_FIELD = 24;
+
+    template <typename VALUE>
+    bool parse_number(string_view const token, VALUE& value) noexcept
+    {
+        auto const [end, error] = from_chars(token.data(), token.data() + token.size(), value);
+        return error == std::errc() && end == token.data() + token.size();
+    }
+}
+
+namespace shared::infrastructure
+{
+
+optional<proc_stat> parse_proc_stat(string_view const content) noexcept
+{
+    auto const open = content.find('(');
+    auto const close = content.rfind(')');
+    if (open == string_view::npos || close == string_view::npos || close < open)
+        return nullopt;
+
+    proc_stat stat{};
+    if (!parse_number(content.substr(0, open > 0 ? open - 1 : 0), stat.process_id))
+        return nullopt;
+
+    auto const comm = content.substr(open + 1, close - open - 1);
+    stat.comm_length = std::min(comm.size(), proc_stat::MAX_COMM_LENGTH - 1);
+    comm.copy(stat.comm.data(), stat.comm_length);
+
+    auto remaining = content.substr(close + 1);
+    auto field = STATE_FIELD;
+    while (!remaining.empty() && field <= RESIDENT_PAGES_FIELD) {
+        auto const start = remaining.find_first_not_of(" \n");
+        if (start == string_view::npos)
+            break;
+        remaining.remove_prefix(start);
+        auto const length = std::min(remaining.find_first_of(" \n"), remaining.size());
+        auto const token = remaining.substr(0, length);
+        remaining.remove_prefix(length);
+
+        bool parsed = true;
+        switch (field) {
+        case STATE_FIELD:
+            stat.state = token.front();
+            break;
+        case PARENT_PROCESS_ID_FIELD:
+            parsed = parse_number(token, stat.parent_process_id);
+            break;
+        case USER_TIME_FIELD:
+            parsed = parse_number(token, stat.user_time);
+            break;
+        case SYSTEM_TIME_FIELD:
+            parsed = parse_number(token, stat.system_time);
+            break;
+        case THREAD_COUNT_FIELD:
+            parsed = parse_number(token, stat.thread_count);
+            break;
+        case START_TIME_FIELD:
+            parsed = parse_number(token, stat.start_time);
+            break;
+        case RESIDENT_PAGES_FIELD:
+            parsed = parse_number(token, stat.resident_pages);
+            break;
+        default:
+            break;
+        }
+        if (!parsed)
+            return nullopt;
+        field++;
+    }
+
+    return field > RESIDENT_PAGES_FIELD
+        ? optional(stat)
+        : nullopt;
+}
+
+}
@@ -0,0 +1,52 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include "shared/shared_export.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>the fields of /proc/[pid]/stat used by process_service</summary>
+    /// <remarks>comm is held inline, mirroring PROCESSENTRY32::szExeFile, so reading an entry never allocates</remarks>
+    struct proc_stat
+    {
+        /// <summary>TASK_COMM_LEN, the kernel truncates comm to this length including the terminator</summary>
+        constexpr static std::size_t MAX_COMM_LENGTH = 16;
+
+        unsigned long process_id{};
+        unsigned long parent_process_id{};
+        char state{};
+        unsigned long thread_count{};
+        /// <summary>user and system time in clock ticks</summary>
+        unsigned long long user_time{};
+        unsigned long long system_time{};
+        /// <summary>clock ticks since boot, together with process_id this identifies a process across pid reuse</summary>
+        unsigned long long start_time{};
+        unsigned long long resident_pages{};
+        std::array<char, MAX_COMM_LENGTH> comm{};
+        std::size_t comm_length{};
+
+        [[nodiscard]] std::string_view name() const noexcept
+        {
+            return std::string_view(comm.data(), comm_length);
+        }
+    };
+
+    /// <summary>parses the content of /proc/[pid]/stat, comm may itself contain spaces or ')' so it is bounded by the last ')'</summary>
+    [[nodiscard]] SHARED_DLL std::optional<proc_stat> parse_proc_stat(std::string_view const content) noexcept;
+
+}
@@ -0,0 +1,54 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include "shared/shared_export.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>platform neutral view of one process as returned from enumeration</summary>
+    struct process_entry
+    {
+        unsigned long process_id{};
+        unsigned long parent_process_id{};
+        unsigned long long start_time{};
+        unsigned long thread_count{};
+        /// <summary>executable name, only valid until the next call to read_next</summary>
+        std::string_view name{};
+    };
+
+    /// <summary>forward only reader over the processes currently running</summary>
+    struct process_entry_reader
+    {
+        /// <summary>restarts enumeration, picking up processes started since the last pass</summary>
+        virtual void rewind() = 0;
+        /// <summary>reads the next entry, returning false once every process has been read</summary>
+        [[nodiscard]] virtual bool read_next(process_entry& entry) = 0;
+
+        process_entry_reader() = default;
+        virtual ~process_entry_reader() = default;
+        process_entry_reader(process_entry_reader const&) = delete;
+        process_entry_reader& operator=(process_entry_reader const&) = delete;
+        process_entry_reader(process_entry_reader&&) noexcept = default;
+        process_entry_reader& operator=(process_entry_reader&&) noexcept = default;
+    };
+
+    using unique_process_entry_reader = std::unique_ptr<process_entry_reader>;
+
+    /// <summary>returns the reader for the current platform, toolhelp on windows and /proc on linux</summary>
+    [[nodiscard]] SHARED_DLL unique_process_entry_reader make_process_entry_reader();
+
+}
@@ -12,7 +12,13 @@
 // 
 
 #include "pch.h"
+
+#ifdef _WIN32
+
 #include "process_impl.h"
+#include <atomic>
+#include <mutex>
+#include <Psapi.h>
 #include <tuple>
 
 using std::find_if;
@@ -43,40 +49,180 @@ using shared::infrastructure::null_handle;
 using shared::infrastructure::invalid_handle;
 using shared::model::unique_process;
 
+namespace
+{
+    /// <summary>held while create_process_adapter has handles temporarily marked inheritable</summary>
+    std::mutex launch_lock{};
+
+    /// <summary>state shared between when_exited and the thread pool callback, freed by whichever finishes last</summary>
+    struct exit_watch final
+    {
+        null_handle process{};
+        HANDLE wait{};
+        std::promise<optional<unsigned long>> exited{};
+        std::atomic<int> references{2};
+
+        void drop_reference() noexcept
+        {
+            if (--references != 0)
+                return;
+            UnregisterWait(wait);
+            delete this;
+        }
+    };
+
+    void CALLBACK on_process_exited(void* context, BOOLEAN)
+    {
+        auto* const watch = static_cast<exit_watch*>(context);
+        DWORD exitCode{};
+        watch->exited.set_value(GetExitCodeProcess(watch->process.Get(), &exitCode)
+            ? optional<unsigned long>(exitCode)
+            : nullopt);
+        watch->drop_reference();
+    }
+}
+
 namespace shared::model
 {
 
-unique_process process_impl::start(string_view const& filename, string_view const& arguments)
+unique_process process_impl::start(string_view const& filename, string_view const& arguments, process_ownership const ownership)
 {
     const auto absolutePath = std::filesystem::absolute(filename).string();
 
     if (!std::filesystem::exists(absolutePath) || !std::filesystem::is_regular_file(absolutePath))
         throw std::invalid_argument("file not found");
 
+    // arguments is already a command line so is passed through untouched, only the filename needs quoting
+    string commandLine{};
+    commandLine.reserve(absolutePath.size() + arguments.size() + 3);
+    append_quoted(commandLine, absolutePath);
+    if (!arguments.empty()) {
+        commandLine.push_back(' ');
+        commandLine.append(arguments);
+    }
+
     STARTUPINFOA startupInfo{};
     startupInfo.cb = sizeof(startupInfo);
     startupInfo.dwFlags = STARTF_USESTDHANDLES;
     PROCESS_INFORMATION process_information{};
 
     unique_process process{};
-    if (!create_process_adapter(absolutePath, arguments, &startupInfo, &process_information))
+    if (!create_process_adapter(commandLine, nullptr, &startupInfo, &process_information))
         return process;
 
     // make_unique won't work unless we do some trickery to make it a friend function
-    return unique_process(new process_impl(process_information));
+    return unique_process(new process_impl(process_information, ownership));
 }
 
-vector<unique_process> process_impl::get_processes_by_name(string_view const& process_name)
+unique_process process_impl::start(process_start_info const& start_info)
 {
-    auto const entries = get_process_entries();
-    vector<unique_process> filtered{};
-    for (auto const& processEntry : entries) {
-        if (auto const exeView = wstring_view(processEntry.szExeFile, wcslen(processEntry.szExeFile));
-            string_equal(process_name, exeView, true)) {
-            filtered.emplace_back(new process_impl(processEntry.th32ProcessID));
+    auto const absolutePath = std::filesystem::absolute(start_info.filename).string();
+
+    if (!std::filesystem::exists(absolutePath) || !std::filesystem::is_regular_file(absolutePath))
+        throw std::invalid_argument("file not found");
+
+    string commandLine{};
+    append_quoted(commandLine, absolutePath);
+    for (auto const& argument : start_info.arguments) {
+        commandLine.push_back(' ');
+        append_quoted(commandLine, argument);
+    }
+
+    // environment block is a sequence of null terminated strings ending in an empty one
+    string environment{};
+    if (start_info.environment.has_value()) {
+        for (auto const& variable : start_info.environment.value()) {
+            environment.append(variable);
+            environment.push_back('\0');
         }
+        environment.push_back('\0');
+    }
+
+    STARTUPINFOA startupInfo{};
+    startupInfo.cb = sizeof(startupInfo);
+    startupInfo.dwFlags = STARTF_USESTDHANDLES;
+    startupInfo.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    startupInfo.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+    startupInfo.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    // pipes are created non-inheritable and create_process_adapter hands the child only the write ends,
+    // which close here once the child has them so reads see end of stream as soon as it exits
+    null_handle standardOutput{};
+    null_handle standardError{};
+    null_handle childOutput{};
+    null_handle childError{};
+    auto const redirect = [](null_handle& read_end, null_handle& write_end, HANDLE& target) {
+        HANDLE readHandle{};
+        HANDLE writeHandle{};
+        if (!CreatePipe(&readHandle, &writeHandle, nullptr, 0))
+            return false;
+        read_end.Reset(readHandle);
+        write_end.Reset(writeHandle);
+        target = writeHandle;
+        return true;
+    };
+    if (start_info.redirect_standard_output && !redirect(standardOutput, childOutput, startupInfo.hStdOutput))
+        return unique_process();
+    if (start_info.redirect_standard_error && !redirect(standardError, childError, startupInfo.hStdError))
+        return unique_process();
+
+    PROCESS_INFORMATION process_information{};
+    if (!create_process_adapter(commandLine, start_info.environment.has_value() ? environment.data() : nullptr, &startupInfo, &process_information))
+        return unique_process();
+
+    // make_unique won't work unless we do some trickery to make it a friend function
+    auto process = unique_ptr<process_impl>(new process_impl(process_information, start_info.ownership));
+    process->m_standard_output = move(standardOutput);
+    process->m_standard_error = move(standardError);
+    return unique_process(process.release());
+}
+
+unique_process process_impl::open(process_key const& key)
+{
+    return unique_process(new process_impl(key.process_id));
+}
+
+optional<std::filesystem::path> process_impl::get_executable_path(process_key const& key)
+{
+    null_handle const process(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, key.process_id));
+    if (!static_cast<bool>(process))
+        return nullopt;
+
+    // start time of zero means toolhelp couldn't read it either, in which case there is nothing to compare
+    if (FILETIME creation{}, exit{}, kernel{}, user{};
+        key.start_time != 0ULL &&
+        (!GetProcessTimes(process.Get(), &creation, &exit, &kernel, &user) ||
+         ((static_cast<unsigned long long>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime) != key.start_time))
+        return nullopt;
+
+    std::wstring path(MAX_PATH, L'\0');
+    auto length = static_cast<DWORD>(path.size());
+    while (!QueryFullProcessImageNameW(process.Get(), 0, path.data(), &length)) {
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || path.size() >= 32768)
+            return nullopt;
+        path.resize(path.size() * 2);
+        length = static_cast<DWORD>(path.size());
     }
-    return filtered;
+    path.resize(length);
+    return optional(std::filesystem::path(path));
+}
+
+bool process_impl::collect_details(process_key const& key, process_details& details)
+{
+    null_handle const process(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, key.process_id));
+    if (!static_cast<bool>(process))
+        return false;
+
+    PROCESS_MEMORY_COUNTERS_EX counters{};
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(process.Get(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+        return false;
+
+    details.resident_bytes = counters.WorkingSetSize;
+    details.private_bytes = counters.PrivateUsage;
+    for (auto const& module : get_module_entries(key.process_id))
+        details.modules.emplace_back(module.szExePath);
+    return true;
 }
 
 unsigned long process_impl::get_id() const noexcept
@@ -122,6 +268,39 @@ void process_impl::wait_for_exit() const noexcept {
         WaitForSingleObject(m_process_handle.Get(), INFINITE);
 }
 
+exit_future process_impl::when_exited() const
+{
+    std::promise<optional<unsigned long>> ready{};
+    if (!is_running()) {
+        ready.set_value(exit_code());
+        return ready.get_future().share();
+    }
+
+    // the wait runs on the thread pool's wait threads, each of which services many handles, so watching
+    // a process costs a registration rather than a blocked thread
+    auto watch = make_unique<exit_watch>();
+    auto future = watch->exited.get_future().share();
+    HANDLE process{};
+    if (!DuplicateHandle(GetCurrentProcess(), m_process_handle.Get(), GetCurrentProcess(), &process, SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, 0))
+        throw std::runtime_error(("DuplicateHandle failed with "s + to_string(GetLastError())).c_str());
+    watch->process.Reset(process);
+
+    if (!RegisterWaitForSingleObject(&watch->wait, watch->process.Get(), on_process_exited, watch.get(), INFINITE, WT_EXECUTEONLYONCE))
+        throw std::runtime_error(("RegisterWaitForSingleObject failed with "s + to_string(GetLastError())).c_str());
+    watch.release()->drop_reference();
+    return future;
+}
+
+std::size_t process_impl::read_standard_output(std::span<char> const buffer) const noexcept
+{
+    return read_stream(m_standard_output, buffer);
+}
+
+std::size_t process_impl::read_standard_error(std::span<char> const buffer) const noexcept
+{
+    return read_stream(m_standard_error, buffer);
+}
+
 optional<std::filesystem::path> process_impl::get_path_to_running_process(string_view const& process_name) const noexcept
 {
     try {
@@ -144,7 +323,8 @@ process_impl::process_impl(unsigned long const process_id)
     m_process_handle.Reset( OpenProcess(PROCESS_ALL_ACCESS, FALSE, process_id));
 }
 
-process_impl::process_impl(PROCESS_INFORMATION const& process_information)
+process_impl::process_impl(PROCESS_INFORMATION const& process_information, process_ownership const ownership)
+    : m_ownership(ownership)
 {
     m_process_handle.Reset(process_information.hProcess);
     m_process_thread_handle.Reset(process_information.hThread);
@@ -157,10 +337,13 @@ process_impl::process_impl(process_impl&& other) noexcept
     : m_process_launched{other.m_process_launched} 
     , m_process_id{other.m_process_id}
     , m_process_thread_id{other.m_process_thread_id}
+    , m_ownership{other.m_ownership}
 {
 
     swap(m_process_handle, other.m_process_handle);
     swap(m_process_thread_handle, other.m_process_thread_handle);
+    swap(m_standard_output, other.m_standard_output);
+    swap(m_standard_error, other.m_standard_error);
 
     other.m_process_thread_id = 0UL;
     other.m_process_id = 0UL;
@@ -170,9 +353,12 @@ process_impl& process_impl::operator=(process_impl&& other) noexcept
 {
     swap(m_process_handle, other.m_process_handle);
     swap(m_process_thread_handle, other.m_process_thread_handle);
+    swap(m_standard_output, other.m_standard_output);
+    swap(m_standard_error, other.m_standard_error);
     m_process_id = other.m_process_id;
     m_process_thread_id = other.m_process_thread_id;
     m_process_launched = other.m_process_launched;
+    m_ownership = other.m_ownership;
 
     other.m_process_thread_id = 0UL;
     other.m_process_id = 0UL;
@@ -182,8 +368,9 @@ process_impl& process_impl::operator=(process_impl&& other) noexcept
 
 process_impl::~process_impl()
 {
-    if (m_process_launched && is_running())
-        wait_for_exit();
+    // never wait here, a detached process is left running and its handle simply closed
+    if (m_process_launched && m_ownership == process_ownership::KILL_ON_DROP && is_running())
+        TerminateProcess(m_process_handle.Get(), 1);
     m_process_launched = false;
     m_process_id = 0UL;
     m_process_thread_id = 0UL;
@@ -275,20 +462,100 @@ std::vector<MODULEENTRY32> process_impl::get_module_entries(unsigned long const
     return modules;
 }
 
-bool process_impl::create_process_adapter(string_view const& filename, string_view const& arguments, STARTUPINFOA * const startup_info, PROCESS_INFORMATION * const process_info)
+bool process_impl::create_process_adapter(string& command_line, char* const environment, STARTUPINFOA * const startup_info, PROCESS_INFORMATION * const process_info)
 {
-    auto const maxPath = 256UL;
-    auto const commandLine = make_unique<char[]>(32768); // max size of command line which cannot be readonly
-    auto const filenameLength = std::min<size_t>(filename.size(), maxPath);
+    // the child inherits its standard handles and nothing else; with bInheritHandles alone it would take
+    // every inheritable handle in this process, including the pipes of a child being started on another
+    // thread, whose reader would then never see end of stream
+    vector<HANDLE> inherited{};
+    for (auto const handle : {startup_info->hStdInput, startup_info->hStdOutput, startup_info->hStdError}) {
+        if (handle != nullptr && handle != INVALID_HANDLE_VALUE && std::find(begin(inherited), end(inherited), handle) == end(inherited))
+            inherited.push_back(handle);
+    }
 
-    filename.copy(commandLine.get(), filenameLength);
-    commandLine[filenameLength] = ' ';
-    arguments.copy(&commandLine.get()[filenameLength+1], std::min<size_t>(arguments.size(), 32768L - maxPath - 1UL));
+    // a handle list may only name inheritable handles, so each is marked inheritable for the duration of
+    // the call and restored after; launches are serialized so one cannot clear the flag on a handle, such
+    // as a shared standard handle, which another is about to pass
+    std::lock_guard const lock(launch_lock);
+    vector<DWORD> flags(inherited.size());
+    auto const restore = [&inherited, &flags](std::size_t const count) {
+        for (std::size_t i = 0; i < count; i++)
+            SetHandleInformation(inherited[i], HANDLE_FLAG_INHERIT, flags[i] & HANDLE_FLAG_INHERIT);
+    };
+    for (std::size_t i = 0; i < inherited.size(); i++) {
+        if (!GetHandleInformation(inherited[i], &flags[i]) ||
+            !SetHandleInformation(inherited[i], HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT)) {
+            restore(i);
+            return false;
+        }
+    }
+
+    STARTUPINFOEXA startupInfo{};
+    startupInfo.StartupInfo = *startup_info;
+    startupInfo.StartupInfo.cb = sizeof(startupInfo);
+
+    vector<char> attributes{};
+    if (!inherited.empty()) {
+        SIZE_T size{};
+        static_cast<void>(InitializeProcThreadAttributeList(nullptr, 1, 0, &size));
+        attributes.resize(size);
+        startupInfo.lpAttributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributes.data());
+        if (!InitializeProcThreadAttributeList(startupInfo.lpAttributeList, 1, 0, &size)) {
+            restore(inherited.size());
+            return false;
+        }
+        if (!UpdateProcThreadAttribute(startupInfo.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+            inherited.data(), inherited.size() * sizeof(HANDLE), nullptr, nullptr)) {
+            DeleteProcThreadAttributeList(startupInfo.lpAttributeList);
+            restore(inherited.size());
+            return false;
+        }
+    }
+
+    // CreateProcess may write to the command line so it can't be readonly, string::data is writable and
+    // sized exactly, anything over the 32767 character limit is left for CreateProcess to reject
+    auto const created = CreateProcessA(nullptr, command_line.data(), nullptr, nullptr, inherited.empty() ? FALSE : TRUE,
+        CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT, environment, nullptr, &startupInfo.StartupInfo, process_info) == TRUE;
+
+    if (startupInfo.lpAttributeList != nullptr)
+        DeleteProcThreadAttributeList(startupInfo.lpAttributeList);
+    restore(inherited.size());
+    return created;
+}
 
-    auto *const commandLineString = commandLine.get();
+void process_impl::append_quoted(string& command_line, string_view const argument)
+{
+    if (!argument.empty() && argument.find_first_of(" \t\n\v\"") == string_view::npos) {
+        command_line.append(argument);
+        return;
+    }
 
-    return CreateProcessA(nullptr, commandLineString, nullptr, nullptr, TRUE, CREATE_NO_WINDOW, 
-        nullptr, nullptr, startup_info, process_info) == TRUE;
+    // backslashes are only special ahead of a quote, where they must be doubled to stay literal
+    command_line.push_back('"');
+    std::size_t backslashes{};
+    for (auto const character : argument) {
+        if (character == '\\') {
+            backslashes++;
+            continue;
+        }
+        command_line.append(character == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        command_line.push_back(character);
+        backslashes = 0;
+    }
+    command_line.append(backslashes * 2, '\\');
+    command_line.push_back('"');
+}
+
+std::size_t process_impl::read_stream(null_handle const& stream, std::span<char> const buffer) noexcept
+{
+    if (!static_cast<bool>(stream) || buffer.empty())
+        return 0;
+
+    // ERROR_BROKEN_PIPE is the normal end of stream once the child and any inheritors have exited
+    DWORD bytesRead{};
+    return ReadFile(stream.Get(), buffer.data(), static_cast<DWORD>(std::min<std::size_t>(buffer.size(), MAXDWORD)), &bytesRead, nullptr)
+        ? static_cast<std::size_t>(bytesRead)
+        : 0;
 }
 
 bool operator==(process_impl const& left_hand_side, process_impl const& right_hand_side)
@@ -296,4 +563,6 @@ bool operator==(process_impl const& left_hand_side, process_impl const& right_ha
     return &left_hand_side == &right_hand_side || left_hand_side.equals(right_hand_side);
 }
 
-}
\ No newline at end of file
+}
+
+#endif
@@ -12,21 +12,37 @@
 // 
 
 #pragma once
+
+#ifdef _WIN32
+
 #include <TlHelp32.h>
 #include "shared/process.h"
+#include "shared/process_delta.h"
+#include "shared/process_details.h"
+#include "shared/process_start_info.h"
 
 namespace shared::model
 {
     class process_impl final : public process
     {
     public:
-        static unique_process start(std::string_view const& filename, std::string_view const& arguments);
-        static std::vector<unique_process> get_processes_by_name(std::string_view const& process_name);
+        static unique_process start(std::string_view const& filename, std::string_view const& arguments, process_ownership const ownership);
+        /// <summary>launches with each argument quoted for CommandLineToArgvW so the child sees the same vector</summary>
+        static unique_process start(process_start_info const& start_info);
+        static unique_process open(process_key const& key);
+        /// <summary>resolves the executable of key with QueryFullProcessImageName, which needs no module snapshot</summary>
+        static std::optional<std::filesystem::path> get_executable_path(process_key const& key);
+        /// <summary>fills the memory counters and modules of details, thread count is left to the caller which has it from toolhelp</summary>
+        static bool collect_details(process_key const& key, process_details& details);
+        static constexpr std::size_t MAX_NAME_LENGTH = std::string_view::npos;
 
         [[nodiscard]] unsigned long get_id() const noexcept final;
         [[nodiscard]] bool is_running() const noexcept final;
         [[nodiscard]] std::optional<unsigned long> exit_code() const noexcept final;
         void wait_for_exit() const noexcept final; 
+        [[nodiscard]] exit_future when_exited() const final;
+        [[nodiscard]] std::size_t read_standard_output(std::span<char> const buffer) const noexcept final;
+        [[nodiscard]] std::size_t read_standard_error(std::span<char> const buffer) const noexcept final;
         [[nodiscard]] std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& process_name) const noexcept final;
 
         process_impl() = default;
@@ -42,11 +58,16 @@ namespace shared::model
         bool m_process_launched{};
         unsigned long m_process_id{};
         unsigned long m_process_thread_id{};
+        process_ownership m_ownership{process_ownership::DETACH};
         shared::infrastructure::null_handle m_process_handle{};
         shared::infrastructure::null_handle m_process_thread_handle{};
+        shared::infrastructure::null_handle m_standard_output{};
+        shared::infrastructure::null_handle m_standard_error{};
 
-        explicit process_impl(PROCESS_INFORMATION const& process_information);
-        static bool create_process_adapter(std::string_view const& filename, std::string_view const& arguments, STARTUPINFOA * const startup_info, PROCESS_INFORMATION * const process_info);
+        explicit process_impl(PROCESS_INFORMATION const& process_information, process_ownership const ownership);
+        static bool create_process_adapter(std::string& command_line, char* const environment, STARTUPINFOA * const startup_info, PROCESS_INFORMATION * const process_info);
+        static void append_quoted(std::string& command_line, std::string_view const argument);
+        [[nodiscard]] static std::size_t read_stream(shared::infrastructure::null_handle const& stream, std::span<char> const buffer) noexcept;
         static std::tuple<bool, unsigned long> get_running_details(HANDLE process_handle);
 
         static std::optional<PROCESSENTRY32> get_process_by_name(std::string_view const& process_name);
@@ -59,3 +80,4 @@ namespace shared::model
 
 }
 
+#endif
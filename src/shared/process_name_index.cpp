@@ -0,0 +1,107 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "process_name_index.h"
+
+using std::span;
+using std::string;
+using std::string_view;
+
+namespace shared::model
+{
+
+process_name_index::process_name_index(std::size_t const max_name_length)
+    : m_max_name_length(max_name_length)
+{
+}
+
+void process_name_index::apply(span<process_delta const> const deltas)
+{
+    for (auto const& delta : deltas) {
+        switch (delta.change) {
+        case process_change::STARTED:
+            add(delta.key, delta.name);
+            break;
+        case process_change::CHANGED:
+            // most changes are thread counts, only move the key when the name itself changed
+            if (auto const current = m_name_by_process.find(delta.key);
+                current == m_name_by_process.end() || !folded_equal()(current->second, delta.name)) {
+                remove(delta.key);
+                add(delta.key, delta.name);
+            }
+            break;
+        case process_change::EXITED:
+            remove(delta.key);
+            break;
+        }
+    }
+}
+
+span<process_key const> process_name_index::find(string_view const name) const
+{
+    if (name.empty())
+        return {};
+
+    auto const match = m_processes_by_name.find(name.substr(0, m_max_name_length));
+    return match != m_processes_by_name.end()
+        ? span<process_key const>(match->second)
+        : span<process_key const>();
+}
+
+std::size_t process_name_index::size() const noexcept
+{
+    return m_name_by_process.size();
+}
+
+bool process_name_index::matches(string_view const name, string_view const process_name, std::size_t const max_name_length) noexcept
+{
+    if (name.empty())
+        return false;
+
+    return folded_equal()(name.substr(0, max_name_length), process_name);
+}
+
+void process_name_index::add(process_key const& key, string_view const name)
+{
+    auto folded = fold(name);
+    m_processes_by_name[folded].push_back(key);
+    m_name_by_process.insert_or_assign(key, std::move(folded));
+}
+
+void process_name_index::remove(process_key const& key)
+{
+    auto const indexed = m_name_by_process.find(key);
+    if (indexed == m_name_by_process.end())
+        return;
+
+    if (auto const bucket = m_processes_by_name.find(indexed->second); bucket != m_processes_by_name.end()) {
+        auto& keys = bucket->second;
+        if (auto const position = std::find(begin(keys), end(keys), key); position != end(keys)) {
+            *position = keys.back();
+            keys.pop_back();
+        }
+        if (keys.empty())
+            m_processes_by_name.erase(bucket);
+    }
+    m_name_by_process.erase(indexed);
+}
+
+string process_name_index::fold(string_view const name)
+{
+    string folded(name);
+    std::transform(begin(folded), end(folded), begin(folded), fold_case);
+    return folded;
+}
+
+}
@@ -0,0 +1,97 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "shared/process_delta.h"
+#include "shared/shared_export.h"
+
+namespace shared::model
+{
+    /// <summary>maps a case folded executable name to the processes currently running under that name</summary>
+    /// <remarks>
+    /// kept current by applying the deltas published by process_table, so lookups are a single hash probe
+    /// regardless of how many processes are running; folding is ASCII only which matches executable names
+    /// on both platforms without the per character locale lookups string_equal performs
+    /// </remarks>
+    class process_name_index final
+    {
+    public:
+        SHARED_DLL void apply(std::span<process_delta const> const deltas);
+
+        /// <summary>returns the processes named name, valid until the next call to apply</summary>
+        [[nodiscard]] SHARED_DLL std::span<process_key const> find(std::string_view const name) const;
+        [[nodiscard]] SHARED_DLL std::size_t size() const noexcept;
+
+        /// <summary>true if process_name is what find would match for name, for one off checks without an index</summary>
+        [[nodiscard]] SHARED_DLL static bool matches(std::string_view const name, std::string_view const process_name, std::size_t const max_name_length) noexcept;
+
+        /// <param name="max_name_length">
+        /// length at which the platform truncates names, longer names are looked up by that prefix
+        /// </param>
+        SHARED_DLL explicit process_name_index(std::size_t const max_name_length = std::string_view::npos);
+        process_name_index(process_name_index const&) = delete;
+        process_name_index& operator=(process_name_index const&) = delete;
+        SHARED_DLL process_name_index(process_name_index&&) noexcept = default;
+        SHARED_DLL process_name_index& operator=(process_name_index&&) noexcept = default;
+        SHARED_DLL ~process_name_index() = default;
+
+    private:
+        [[nodiscard]] static constexpr char fold_case(char const value) noexcept
+        {
+            return value >= 'A' && value <= 'Z'
+                ? static_cast<char>(value - 'A' + 'a')
+                : value;
+        }
+
+        // keys are stored folded, hashing and comparing as if folded lets find probe with the name as given
+        struct folded_hash
+        {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view const value) const noexcept
+            {
+                std::uint64_t hash = 14695981039346656037ULL;
+                for (auto const character : value)
+                    hash = (hash ^ static_cast<unsigned char>(fold_case(character))) * 1099511628211ULL;
+                return static_cast<std::size_t>(hash);
+            }
+        };
+        struct folded_equal
+        {
+            using is_transparent = void;
+            bool operator()(std::string_view const lhs, std::string_view const rhs) const noexcept
+            {
+                return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](char const left, char const right) {
+                        return fold_case(left) == fold_case(right);
+                    });
+            }
+        };
+
+        std::size_t m_max_name_length;
+        std::unordered_map<std::string, std::vector<process_key>, folded_hash, folded_equal> m_processes_by_name{};
+        std::unordered_map<process_key, std::string> m_name_by_process{};
+
+        void add(process_key const& key, std::string_view const name);
+        void remove(process_key const& key);
+        [[nodiscard]] static std::string fold(std::string_view const name);
+    };
+
+}
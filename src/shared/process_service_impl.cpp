@@ -13,16 +13,37 @@
 
 #include "pch.h"
 #include "process_service_impl.h"
-#include "process_impl.h"
+#include "parallel_for.h"
+#include <unordered_map>
+
+#ifdef _WIN32
+#   include "process_impl.h"
+#else
+#   include "proc_process_impl.h"
+#endif
 
-using std::back_inserter;
 using std::move;
+using std::nullopt;
 using std::optional;
+using std::span;
 using std::string_view;
-using std::transform;
 using std::vector;
 
+using shared::infrastructure::default_worker_count;
+using shared::infrastructure::make_process_entry_reader;
+using shared::infrastructure::parallel_for;
+
+#ifdef _WIN32
 using shared::model::process_impl;
+#else
+using process_impl = shared::model::proc_process_impl;
+#endif
+using shared::model::process_delta_handler;
+using shared::model::process_details;
+using shared::model::process_key;
+using shared::model::process_ownership;
+using shared::model::process_start_info;
+using shared::model::process_table;
 using shared::model::unique_process;
 
 namespace shared::service
@@ -37,10 +58,28 @@ unique_process_service make_unique_process_service()
     return std::make_unique<process_service_impl>();
 }
 
+process_service_impl::process_service_impl()
+    : m_names(process_impl::MAX_NAME_LENGTH)
+{
+}
+
 unique_process process_service_impl::start_process(string_view const& filename, string_view const& arguments) const noexcept
+{
+    return start_process(filename, arguments, process_ownership::DETACH);
+}
+unique_process process_service_impl::start_process(string_view const& filename, string_view const& arguments, process_ownership const ownership) const noexcept
 {
     try {
-        return unique_process(process_impl::start(filename, arguments));
+        return unique_process(process_impl::start(filename, arguments, ownership));
+    }
+    catch (const std::exception&) {
+        return unique_process();
+    }
+}
+unique_process process_service_impl::start_process(process_start_info const& start_info) const noexcept
+{
+    try {
+        return unique_process(process_impl::start(start_info));
     }
     catch (const std::exception&) {
         return unique_process();
@@ -49,26 +88,141 @@ unique_process process_service_impl::start_process(string_view const& filename,
 vector<unique_process> process_service_impl::get_processes_by_name(string_view const& process_name) const noexcept
 {
     try {
-        const size_t minimumSize = 100;
-        auto process_implementations = process_impl::get_processes_by_name(process_name);
-        vector<unique_process> processes{};
-        processes.reserve(minimumSize);
-
-        transform(begin(process_implementations), end(process_implementations), back_inserter(processes),
-            [](auto& pImpl) {
-                return unique_process(move(pImpl));
-            });
+        std::lock_guard const lock(m_table_lock);
+        refresh_table();
+        return open_processes_named(process_name);
+    }
+    catch (std::exception const&) {
+        return vector<unique_process>();
+    }
+}
+vector<vector<unique_process>> process_service_impl::get_processes_by_names(span<string_view const> const process_names) const noexcept
+{
+    try {
+        vector<vector<unique_process>> processes{};
+        processes.reserve(process_names.size());
 
+        std::lock_guard const lock(m_table_lock);
+        refresh_table();
+        for (auto const& process_name : process_names)
+            processes.push_back(open_processes_named(process_name));
         return processes;
     }
     catch (std::exception const&) {
-        return vector<unique_process>();
+        return vector<vector<unique_process>>();
     }
 }
 optional<std::filesystem::path> process_service_impl::get_path_to_running_process(string_view const& process_name) const noexcept
 {
-    return process_impl().get_path_to_running_process(process_name);
+    try {
+        std::lock_guard const lock(m_table_lock);
+
+        // a cached path for a process which is still running answers without polling at all
+        for (auto const& key : m_names.find(process_name)) {
+            if (auto const* const cached = m_paths.find(key);
+                cached != nullptr && cached->has_value() && process_impl::open(key)->is_running())
+                return *cached;
+        }
+
+        refresh_table();
+        for (auto const& key : m_names.find(process_name)) {
+            if (auto const& path = m_paths.get(key, process_impl::get_executable_path); path.has_value())
+                return path;
+        }
+        return nullopt;
+    }
+    catch (std::exception const&) {
+        return nullopt;
+    }
 }
 
+vector<process_details> process_service_impl::collect_details(span<unsigned long const> const process_ids) const noexcept
+{
+    try {
+        vector<process_details> details(process_ids.size());
+        vector<optional<process_key>> keys(process_ids.size());
+        {
+            std::unordered_map<unsigned long, optional<process_key>> running{};
+            for (auto const processId : process_ids)
+                running.emplace(processId, nullopt);
+
+            std::lock_guard const lock(m_table_lock);
+            refresh_table();
+            m_table.for_each([&running](process_key const& key, process_table::row const&) {
+                if (auto const requested = running.find(key.process_id); requested != running.end())
+                    requested->second = key;
+            });
+
+            for (std::size_t i = 0; i < process_ids.size(); i++) {
+                details[i].process_id = process_ids[i];
+                keys[i] = running.at(process_ids[i]);
+                if (keys[i].has_value())
+                    details[i].thread_count = m_table.find(keys[i].value())->thread_count;
+            }
+        }
+
+        // the per process work is file or handle io with no shared state, so it runs outside the table lock
+        parallel_for(details.size(), default_worker_count(), [&keys, &details](std::size_t const index) {
+            if (!keys[index].has_value())
+                return;
+            try {
+                details[index].available = process_impl::collect_details(keys[index].value(), details[index]);
+            }
+            catch (std::exception const&) {
+                details[index].available = false;
+            }
+            if (!details[index].available)
+                details[index] = process_details{details[index].process_id};
+        });
+        return details;
+    }
+    catch (std::exception const&) {
+        return vector<process_details>();
+    }
+}
+
+std::size_t process_service_impl::subscribe(process_delta_handler handler)
+{
+    std::lock_guard const lock(m_table_lock);
+    return m_table.subscribe(move(handler));
+}
+
+void process_service_impl::unsubscribe(std::size_t const subscription) noexcept
+{
+    std::lock_guard const lock(m_table_lock);
+    m_table.unsubscribe(subscription);
+}
 
-}
\ No newline at end of file
+void process_service_impl::refresh() noexcept
+{
+    try {
+        std::lock_guard const lock(m_table_lock);
+        refresh_table();
+    }
+    catch (std::exception const&) {
+        // reading the process list failed, there is nothing to report and the next refresh polls again
+    }
+}
+
+void process_service_impl::refresh_table() const
+{
+    if (!m_reader)
+        m_reader = make_process_entry_reader();
+    // the index and cache take the deltas before subscribers do, as the table never publishes them again
+    auto const deltas = m_table.update(*m_reader);
+    m_names.apply(deltas);
+    m_paths.apply(deltas);
+    m_table.publish();
+}
+
+vector<unique_process> process_service_impl::open_processes_named(string_view const& process_name) const
+{
+    auto const keys = m_names.find(process_name);
+    vector<unique_process> processes{};
+    processes.reserve(keys.size());
+    for (auto const& key : keys)
+        processes.push_back(process_impl::open(key));
+    return processes;
+}
+
+}
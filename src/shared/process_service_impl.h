@@ -13,23 +13,47 @@
 
 #pragma once
 
+#include <mutex>
 #include "shared/process_service.h"
 #include "shared/shared_export.h"
+#include "module_path_cache.h"
+#include "process_entry.h"
+#include "process_name_index.h"
+#include "process_table.h"
 
 namespace shared::service {
 
     class process_service_impl final : public process_service {
     public:
         [[nodiscard]] SHARED_DLL unique_process start_process(std::string_view const& filename, std::string_view const& arguments) const noexcept override;
+        [[nodiscard]] SHARED_DLL unique_process start_process(std::string_view const& filename, std::string_view const& arguments, shared::model::process_ownership const ownership) const noexcept override;
+        [[nodiscard]] SHARED_DLL unique_process start_process(shared::model::process_start_info const& start_info) const noexcept override;
         [[nodiscard]] SHARED_DLL std::vector<unique_process> get_processes_by_name(std::string_view const& process_name) const noexcept override;
+        [[nodiscard]] SHARED_DLL std::vector<std::vector<unique_process>> get_processes_by_names(std::span<std::string_view const> const process_names) const noexcept override;
         [[nodiscard]] SHARED_DLL std::optional<std::filesystem::path> get_path_to_running_process(std::string_view const& process_name) const noexcept override;
+        [[nodiscard]] SHARED_DLL std::vector<shared::model::process_details> collect_details(std::span<unsigned long const> const process_ids) const noexcept override;
 
-        SHARED_DLL process_service_impl() = default;
-        SHARED_DLL process_service_impl(const process_service_impl&) = default;
-        SHARED_DLL process_service_impl(process_service_impl&&) noexcept = default;
-        SHARED_DLL process_service_impl& operator=(const process_service_impl&) = default;
-        SHARED_DLL process_service_impl& operator=(process_service_impl&&) noexcept = default;
+        [[nodiscard]] SHARED_DLL std::size_t subscribe(shared::model::process_delta_handler handler) override;
+        SHARED_DLL void unsubscribe(std::size_t const subscription) noexcept override;
+        SHARED_DLL void refresh() noexcept override;
+
+        SHARED_DLL process_service_impl();
+        process_service_impl(const process_service_impl&) = delete;
+        process_service_impl(process_service_impl&&) noexcept = delete;
+        process_service_impl& operator=(const process_service_impl&) = delete;
+        process_service_impl& operator=(process_service_impl&&) noexcept = delete;
         SHARED_DLL ~process_service_impl() override = default;
+
+    private:
+        // lookups poll through the table so the state they keep is shared with refresh, hence mutable behind the lock
+        mutable std::mutex m_table_lock{};
+        mutable shared::model::process_table m_table{};
+        mutable shared::model::process_name_index m_names;
+        mutable shared::model::module_path_cache m_paths{};
+        mutable shared::infrastructure::unique_process_entry_reader m_reader{};
+
+        void refresh_table() const;
+        [[nodiscard]] std::vector<unique_process> open_processes_named(std::string_view const& process_name) const;
     };
 
     [[nodiscard]] inline shared_process_service make_shared_process_service()
@@ -0,0 +1,128 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "process_table.h"
+#include <exception>
+
+using std::span;
+
+using shared::infrastructure::process_entry;
+using shared::infrastructure::process_entry_reader;
+
+namespace shared::model
+{
+
+span<process_delta const> process_table::refresh(process_entry_reader& reader)
+{
+    static_cast<void>(update(reader));
+    publish();
+    return m_deltas;
+}
+
+span<process_delta const> process_table::update(process_entry_reader& reader)
+{
+    // rows which exited last time were kept so the names in those deltas outlived the handlers
+    remove_exited();
+    m_deltas.clear();
+    m_generation++;
+
+    reader.rewind();
+    process_entry entry{};
+    while (reader.read_next(entry)) {
+        process_key const key{entry.process_id, entry.start_time};
+        auto [position, inserted] = m_rows.try_emplace(key);
+        auto& current = position->second;
+        current.last_seen = m_generation;
+
+        if (inserted) {
+            current.parent_process_id = entry.parent_process_id;
+            current.thread_count = entry.thread_count;
+            current.name.assign(entry.name);
+            m_deltas.push_back({process_change::STARTED, key, current.parent_process_id, current.thread_count, current.name});
+            continue;
+        }
+
+        if (current.parent_process_id == entry.parent_process_id &&
+            current.thread_count == entry.thread_count &&
+            current.name == entry.name)
+            continue;
+
+        current.parent_process_id = entry.parent_process_id;
+        current.thread_count = entry.thread_count;
+        if (current.name != entry.name)
+            current.name.assign(entry.name);
+        m_deltas.push_back({process_change::CHANGED, key, current.parent_process_id, current.thread_count, current.name});
+    }
+
+    for (auto const& [key, value] : m_rows) {
+        if (value.last_seen == m_generation)
+            continue;
+        m_exited.push_back(key);
+        m_deltas.push_back({process_change::EXITED, key, value.parent_process_id, value.thread_count, value.name});
+    }
+
+    return m_deltas;
+}
+
+void process_table::publish() const
+{
+    if (m_deltas.empty())
+        return;
+
+    span<process_delta const> const deltas(m_deltas);
+    for (auto const& [subscription, handler] : m_handlers) {
+        try {
+            handler(deltas);
+        }
+        catch (std::exception const&) {
+            // the deltas are not published again, so one failing subscriber must not cost the rest theirs
+        }
+    }
+}
+
+std::size_t process_table::subscribe(process_delta_handler handler)
+{
+    auto const subscription = m_next_subscription++;
+    m_handlers.emplace_back(subscription, std::move(handler));
+    return subscription;
+}
+
+void process_table::unsubscribe(std::size_t const subscription) noexcept
+{
+    std::erase_if(m_handlers, [subscription](auto const& handler) {
+        return handler.first == subscription;
+    });
+}
+
+std::size_t process_table::size() const noexcept
+{
+    return m_rows.size() - m_exited.size();
+}
+
+process_table::row const* process_table::find(process_key const& key) const noexcept
+{
+    auto const match = m_rows.find(key);
+    return match != m_rows.end() && match->second.last_seen == m_generation
+        ? &match->second
+        : nullptr;
+}
+
+void process_table::remove_exited() noexcept
+{
+    for (auto const& key : m_exited)
+        m_rows.erase(key);
+    m_exited.clear();
+}
+
+}
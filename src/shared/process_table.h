@@ -0,0 +1,83 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shared/process_delta.h"
+#include "shared/shared_export.h"
+#include "process_entry.h"
+
+namespace shared::model
+{
+    /// <summary>process list kept between polls, each refresh reports only what started, exited or changed since the last</summary>
+    /// <remarks>not thread safe, owners are expected to serialize refresh and lookups</remarks>
+    class process_table final
+    {
+    public:
+        struct row
+        {
+            unsigned long parent_process_id{};
+            unsigned long thread_count{};
+            std::string name{};
+            std::uint64_t last_seen{};
+        };
+
+        /// <summary>reads every entry from reader, publishes the resulting deltas to subscribers and returns them</summary>
+        /// <remarks>the returned deltas remain valid until the next refresh</remarks>
+        SHARED_DLL std::span<process_delta const> refresh(shared::infrastructure::process_entry_reader& reader);
+        /// <summary>as refresh without publishing, so state kept alongside the table can take the deltas before any subscriber runs</summary>
+        SHARED_DLL std::span<process_delta const> update(shared::infrastructure::process_entry_reader& reader);
+        /// <summary>passes the deltas of the last update to each subscriber in turn</summary>
+        /// <remarks>a subscriber which throws a std::exception does not stop the others receiving them</remarks>
+        SHARED_DLL void publish() const;
+
+        [[nodiscard]] SHARED_DLL std::size_t subscribe(process_delta_handler handler);
+        SHARED_DLL void unsubscribe(std::size_t const subscription) noexcept;
+
+        [[nodiscard]] SHARED_DLL std::size_t size() const noexcept;
+        [[nodiscard]] SHARED_DLL row const* find(process_key const& key) const noexcept;
+
+        /// <summary>calls action with the key and row of every running process</summary>
+        template <typename ACTION>
+        void for_each(ACTION&& action) const
+        {
+            for (auto const& [key, value] : m_rows) {
+                if (value.last_seen == m_generation)
+                    action(key, value);
+            }
+        }
+
+        SHARED_DLL process_table() = default;
+        process_table(process_table const&) = delete;
+        process_table& operator=(process_table const&) = delete;
+        SHARED_DLL process_table(process_table&&) noexcept = default;
+        SHARED_DLL process_table& operator=(process_table&&) noexcept = default;
+        SHARED_DLL ~process_table() = default;
+
+    private:
+        // node based so names stay put while rows are added, which keeps published name views valid
+        std::unordered_map<process_key, row> m_rows{};
+        std::vector<process_key> m_exited{};
+        std::vector<process_delta> m_deltas{};
+        std::vector<std::pair<std::size_t, process_delta_handler>> m_handlers{};
+        std::size_t m_next_subscription{1};
+        std::uint64_t m_generation{};
+
+        void remove_exited() noexcept;
+    };
+
+}
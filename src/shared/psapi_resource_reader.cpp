@@ -0,0 +1,116 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#ifdef _WIN32
+
+#include "psapi_resource_reader.h"
+#include "toolhelp_entry_reader.h"
+#include <Psapi.h>
+#include <TlHelp32.h>
+
+using std::nullopt;
+using std::optional;
+using std::pair;
+
+using shared::model::process_key;
+using shared::model::resource_sample;
+
+namespace
+{
+    [[nodiscard]] std::chrono::nanoseconds to_nanoseconds(FILETIME const& value) noexcept
+    {
+        // FILETIME durations count 100ns intervals
+        auto const intervals = (static_cast<unsigned long long>(value.dwHighDateTime) << 32) | value.dwLowDateTime;
+        return std::chrono::nanoseconds(intervals * 100ULL);
+    }
+}
+
+namespace shared::infrastructure
+{
+
+unique_resource_reader make_resource_reader()
+{
+    return std::make_unique<psapi_resource_reader>();
+}
+
+void psapi_resource_reader::begin_round()
+{
+    m_thread_counts.clear();
+
+    invalid_handle const snapshot(CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0));
+    if (!static_cast<bool>(snapshot))
+        return;
+
+    PROCESSENTRY32 entry{};
+    entry.dwSize = sizeof(PROCESSENTRY32);
+    for (auto found = Process32First(snapshot.Get(), &entry); found; found = Process32Next(snapshot.Get(), &entry))
+        m_thread_counts.emplace_back(entry.th32ProcessID, entry.cntThreads);
+    std::sort(begin(m_thread_counts), end(m_thread_counts));
+}
+
+optional<unsigned long long> psapi_resource_reader::get_start_time(unsigned long const process_id)
+{
+    auto const startTime = toolhelp_entry_reader::get_start_time(process_id);
+    return startTime != 0ULL
+        ? optional(startTime)
+        : nullopt;
+}
+
+read_result psapi_resource_reader::read(process_key const& key, resource_sample& sample)
+{
+    // OpenProcess fails with ERROR_INVALID_PARAMETER for an id with no process behind it, anything else such
+    // as ERROR_ACCESS_DENIED leaves the process running but unreadable for now
+    null_handle const process(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, key.process_id));
+    if (!static_cast<bool>(process))
+        return GetLastError() == ERROR_INVALID_PARAMETER ? read_result::EXITED : read_result::UNAVAILABLE;
+
+    FILETIME creation{};
+    FILETIME exit{};
+    FILETIME kernel{};
+    FILETIME user{};
+    if (!GetProcessTimes(process.Get(), &creation, &exit, &kernel, &user))
+        return read_result::UNAVAILABLE;
+    if (((static_cast<unsigned long long>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime) != key.start_time)
+        return read_result::EXITED;
+
+    DWORD exitCode{};
+    if (!GetExitCodeProcess(process.Get(), &exitCode))
+        return read_result::UNAVAILABLE;
+    if (exitCode != STILL_ACTIVE)
+        return read_result::EXITED;
+
+    sample.user_time = to_nanoseconds(user);
+    sample.system_time = to_nanoseconds(kernel);
+
+    PROCESS_MEMORY_COUNTERS_EX counters{};
+    counters.cb = sizeof(counters);
+    if (GetProcessMemoryInfo(process.Get(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+        sample.resident_bytes = counters.WorkingSetSize;
+        sample.private_bytes = counters.PrivateUsage;
+    }
+
+    DWORD handleCount{};
+    if (GetProcessHandleCount(process.Get(), &handleCount))
+        sample.handle_count = handleCount;
+
+    auto const threads = std::lower_bound(begin(m_thread_counts), end(m_thread_counts), pair(key.process_id, 0UL));
+    if (threads != end(m_thread_counts) && threads->first == key.process_id)
+        sample.thread_count = threads->second;
+    return read_result::SAMPLED;
+}
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#ifdef _WIN32
+
+#include <utility>
+#include <vector>
+#include "resource_reader.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>resource_reader over GetProcessTimes, GetProcessMemoryInfo and GetProcessHandleCount</summary>
+    /// <remarks>
+    /// there is no per process call for the thread count so each round takes one toolhelp snapshot and
+    /// keeps the counts in a vector whose capacity is reused from round to round
+    /// </remarks>
+    class psapi_resource_reader final : public resource_reader
+    {
+    public:
+        void begin_round() override;
+        [[nodiscard]] std::optional<unsigned long long> get_start_time(unsigned long const process_id) override;
+        [[nodiscard]] read_result read(shared::model::process_key const& key, shared::model::resource_sample& sample) override;
+
+    private:
+        std::vector<std::pair<unsigned long, unsigned long>> m_thread_counts{};
+    };
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include "shared/process_delta.h"
+#include "shared/resource_sample.h"
+#include "shared/shared_export.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>outcome of reading the counters of a process</summary>
+    enum class read_result
+    {
+        /// <summary>sample was filled</summary>
+        SAMPLED,
+        /// <summary>counters could not be read this time, such as when access is denied, but the process may still be running</summary>
+        UNAVAILABLE,
+        /// <summary>the process has exited or its id now belongs to another process</summary>
+        EXITED,
+    };
+
+    /// <summary>reads the resource counters of individual processes for resource_sampler</summary>
+    struct resource_reader
+    {
+        /// <summary>called once before each round of reads, for platforms which gather some counters for every process at once</summary>
+        virtual void begin_round() = 0;
+        /// <summary>returns the start time of process_id, which together with it forms the process key</summary>
+        [[nodiscard]] virtual std::optional<unsigned long long> get_start_time(unsigned long const process_id) = 0;
+        /// <summary>fills sample for key, distinguishing a process which has gone from one which could not be read</summary>
+        [[nodiscard]] virtual read_result read(shared::model::process_key const& key, shared::model::resource_sample& sample) = 0;
+
+        resource_reader() = default;
+        virtual ~resource_reader() = default;
+        resource_reader(resource_reader const&) = delete;
+        resource_reader& operator=(resource_reader const&) = delete;
+        resource_reader(resource_reader&&) noexcept = default;
+        resource_reader& operator=(resource_reader&&) noexcept = default;
+    };
+
+    using unique_resource_reader = std::unique_ptr<resource_reader>;
+
+    /// <summary>returns the reader for the current platform, psapi on windows and /proc on linux</summary>
+    [[nodiscard]] SHARED_DLL unique_resource_reader make_resource_reader();
+
+}
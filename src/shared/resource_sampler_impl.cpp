@@ -0,0 +1,165 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "resource_sampler_impl.h"
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::move;
+using std::vector;
+
+using shared::infrastructure::make_resource_reader;
+using shared::infrastructure::read_result;
+using shared::infrastructure::ring_buffer;
+using shared::infrastructure::unique_resource_reader;
+using shared::model::process_key;
+using shared::model::resource_sample;
+using shared::model::unique_process;
+
+namespace shared::service
+{
+
+unique_resource_sampler make_resource_sampler(std::size_t const samples_per_process)
+{
+    return std::make_unique<resource_sampler_impl>(samples_per_process, make_resource_reader());
+}
+
+bool resource_sampler_impl::add(unique_process target)
+{
+    if (!target || !target->is_running())
+        return false;
+
+    auto const processId = target->get_id();
+    std::lock_guard const lock(m_lock);
+    auto const startTime = m_reader->get_start_time(processId);
+    if (!startTime.has_value())
+        return false;
+
+    process_key const key{processId, startTime.value()};
+    auto const existing = find(processId);
+    if (existing != m_targets.end() && existing->key == key)
+        return false;
+
+    // a different start time means the id has been reused, so the process held for it has exited and gives way
+    if (existing != m_targets.end())
+        m_targets.erase(existing);
+    m_targets.push_back({move(target), key, ring_buffer<resource_sample>(m_samples_per_process)});
+    return true;
+}
+
+void resource_sampler_impl::remove(unsigned long const process_id) noexcept
+{
+    std::lock_guard const lock(m_lock);
+    std::erase_if(m_targets, [process_id](target const& current) {
+        return current.key.process_id == process_id;
+    });
+}
+
+std::size_t resource_sampler_impl::size() const noexcept
+{
+    std::lock_guard const lock(m_lock);
+    return m_targets.size();
+}
+
+void resource_sampler_impl::sample() noexcept
+{
+    try {
+        std::lock_guard const lock(m_lock);
+        m_reader->begin_round();
+
+        auto const taken = steady_clock::now();
+        for (auto& current : m_targets) {
+            if (current.exited)
+                continue;
+
+            resource_sample sample{};
+            sample.taken = taken;
+            switch (m_reader->read(current.key, sample)) {
+            case read_result::SAMPLED:
+                current.samples.push(sample);
+                break;
+            case read_result::EXITED:
+                current.exited = true;
+                break;
+            case read_result::UNAVAILABLE:
+                // a transient failure loses this sample only, the target is tried again next round
+                break;
+            }
+        }
+    }
+    catch (std::exception const&) {
+        // the round is lost, the next picks up where this left off
+    }
+}
+
+void resource_sampler_impl::start(milliseconds const interval)
+{
+    stop();
+    m_thread = std::jthread([this, interval](std::stop_token const stop_token) {
+        auto next = steady_clock::now();
+        while (!stop_token.stop_requested()) {
+            sample();
+
+            // scheduled from the previous deadline so the time spent sampling doesn't accumulate as drift,
+            // a round which overran starts the next immediately rather than trying to catch up
+            next = std::max(next + interval, steady_clock::now());
+            std::unique_lock lock(m_wait_lock);
+            static_cast<void>(m_wake.wait_until(lock, stop_token, next, [] { return false; }));
+        }
+    });
+}
+
+void resource_sampler_impl::stop() noexcept
+{
+    if (!m_thread.joinable())
+        return;
+    m_thread.request_stop();
+    m_thread.join();
+}
+
+vector<resource_sample> resource_sampler_impl::get_samples(unsigned long const process_id) const
+{
+    std::lock_guard const lock(m_lock);
+    auto const match = find(process_id);
+    if (match == m_targets.end())
+        return vector<resource_sample>();
+
+    vector<resource_sample> samples{};
+    samples.reserve(match->samples.size());
+    for (std::size_t i = 0; i < match->samples.size(); i++)
+        samples.push_back(match->samples[i]);
+    return samples;
+}
+
+resource_sampler_impl::resource_sampler_impl(std::size_t const samples_per_process, unique_resource_reader reader)
+    : m_samples_per_process(samples_per_process)
+    , m_reader(move(reader))
+{
+    if (samples_per_process == 0)
+        throw std::invalid_argument("samples_per_process must be positive");
+}
+
+resource_sampler_impl::~resource_sampler_impl()
+{
+    stop();
+}
+
+vector<resource_sampler_impl::target>::const_iterator resource_sampler_impl::find(unsigned long const process_id) const noexcept
+{
+    return std::find_if(m_targets.begin(), m_targets.end(), [process_id](target const& current) {
+        return current.key.process_id == process_id;
+    });
+}
+
+}
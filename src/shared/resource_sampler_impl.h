@@ -0,0 +1,69 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "shared/process_delta.h"
+#include "shared/resource_sampler.h"
+#include "shared/ring_buffer.h"
+#include "shared/shared_export.h"
+#include "resource_reader.h"
+
+namespace shared::service
+{
+    class resource_sampler_impl final : public resource_sampler
+    {
+    public:
+        [[nodiscard]] SHARED_DLL bool add(unique_process target) override;
+        SHARED_DLL void remove(unsigned long const process_id) noexcept override;
+        [[nodiscard]] SHARED_DLL std::size_t size() const noexcept override;
+
+        SHARED_DLL void sample() noexcept override;
+        SHARED_DLL void start(std::chrono::milliseconds const interval) override;
+        SHARED_DLL void stop() noexcept override;
+
+        [[nodiscard]] SHARED_DLL std::vector<resource_sample> get_samples(unsigned long const process_id) const override;
+
+        SHARED_DLL explicit resource_sampler_impl(std::size_t const samples_per_process, shared::infrastructure::unique_resource_reader reader);
+        resource_sampler_impl(resource_sampler_impl const&) = delete;
+        resource_sampler_impl& operator=(resource_sampler_impl const&) = delete;
+        resource_sampler_impl(resource_sampler_impl&&) noexcept = delete;
+        resource_sampler_impl& operator=(resource_sampler_impl&&) noexcept = delete;
+        SHARED_DLL ~resource_sampler_impl() override;
+
+    private:
+        struct target
+        {
+            unique_process process;
+            shared::model::process_key key;
+            shared::infrastructure::ring_buffer<resource_sample> samples;
+            bool exited{};
+        };
+
+        std::size_t m_samples_per_process;
+        mutable std::mutex m_lock{};
+        shared::infrastructure::unique_resource_reader m_reader;
+        std::vector<target> m_targets{};
+
+        std::mutex m_wait_lock{};
+        std::condition_variable_any m_wake{};
+        std::jthread m_thread{};
+
+        [[nodiscard]] std::vector<target>::const_iterator find(unsigned long const process_id) const noexcept;
+    };
+
+}
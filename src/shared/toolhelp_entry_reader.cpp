@@ -0,0 +1,79 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#ifdef _WIN32
+
+#include "toolhelp_entry_reader.h"
+
+using std::string_view;
+
+namespace shared::infrastructure
+{
+
+unique_process_entry_reader make_process_entry_reader()
+{
+    return std::make_unique<toolhelp_entry_reader>();
+}
+
+void toolhelp_entry_reader::rewind()
+{
+    m_snapshot.Reset(CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0));
+    m_first = true;
+}
+
+bool toolhelp_entry_reader::read_next(process_entry& entry)
+{
+    if (!static_cast<bool>(m_snapshot))
+        return false;
+
+    m_current.dwSize = sizeof(PROCESSENTRY32);
+    auto const found = m_first
+        ? Process32First(m_snapshot.Get(), &m_current)
+        : Process32Next(m_snapshot.Get(), &m_current);
+    m_first = false;
+    if (!found)
+        return false;
+
+    auto const length = WideCharToMultiByte(CP_UTF8, 0, m_current.szExeFile, -1, m_name, MAX_PATH, nullptr, nullptr);
+
+    entry.process_id = m_current.th32ProcessID;
+    entry.parent_process_id = m_current.th32ParentProcessID;
+    entry.thread_count = m_current.cntThreads;
+    entry.start_time = get_start_time(m_current.th32ProcessID);
+    entry.name = length > 0
+        ? string_view(m_name, static_cast<std::size_t>(length - 1))
+        : string_view();
+    return true;
+}
+
+unsigned long long toolhelp_entry_reader::get_start_time(unsigned long const process_id) noexcept
+{
+    null_handle const process(OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process_id));
+    if (!static_cast<bool>(process))
+        return 0ULL;
+
+    FILETIME creation{};
+    FILETIME exit{};
+    FILETIME kernel{};
+    FILETIME user{};
+    if (!GetProcessTimes(process.Get(), &creation, &exit, &kernel, &user))
+        return 0ULL;
+
+    return (static_cast<unsigned long long>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+}
+
+}
+
+#endif
@@ -0,0 +1,46 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#ifdef _WIN32
+
+#include <TlHelp32.h>
+#include "process_entry.h"
+
+namespace shared::infrastructure
+{
+    /// <summary>process_entry_reader over a toolhelp snapshot, rewind takes a new snapshot</summary>
+    /// <remarks>
+    /// PROCESSENTRY32 carries no start time so each entry opens the process for GetProcessTimes, processes
+    /// which cannot be opened report a start time of zero and are identified by process id alone
+    /// </remarks>
+    class toolhelp_entry_reader final : public process_entry_reader
+    {
+    public:
+        void rewind() override;
+        [[nodiscard]] bool read_next(process_entry& entry) override;
+
+        /// <summary>creation time of process_id as a FILETIME, zero when the process cannot be opened</summary>
+        [[nodiscard]] static unsigned long long get_start_time(unsigned long const process_id) noexcept;
+
+    private:
+        invalid_handle m_snapshot{};
+        bool m_first{true};
+        PROCESSENTRY32 m_current{};
+        char m_name[MAX_PATH]{};
+    };
+
+}
+
+#endif
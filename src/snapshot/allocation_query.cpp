@@ -0,0 +1,231 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "allocation_query.h"
+#include "frame_text.h"
+
+using std::span;
+using std::string_view;
+using std::vector;
+
+using snapshot::infrastructure::function_name;
+
+namespace
+{
+    using snapshot::model::allocation_order;
+
+    template <typename ROW>
+    [[nodiscard]] bool ranks_above(ROW const& left, ROW const& right, allocation_order const order) noexcept
+    {
+        switch (order) {
+        case allocation_order::COUNT:
+            if (left.count != right.count)
+                return left.count > right.count;
+            break;
+        case allocation_order::GROWTH:
+            if (left.bytes_delta != right.bytes_delta)
+                return left.bytes_delta > right.bytes_delta;
+            break;
+        case allocation_order::BYTES:
+        default:
+            if (left.bytes != right.bytes)
+                return left.bytes > right.bytes;
+            break;
+        }
+        return false;
+    }
+
+    /// <summary>min heap of the best count values offered so far, ordered by better</summary>
+    template <typename VALUE, typename BETTER>
+    class best_of final
+    {
+    public:
+        void offer(VALUE const& value)
+        {
+            if (m_count == 0 || (m_best.size() == m_count && !m_better(value, m_best.front())))
+                return;
+            m_best.push_back(value);
+            std::push_heap(m_best.begin(), m_best.end(), m_better);
+            if (m_best.size() > m_count) {
+                std::pop_heap(m_best.begin(), m_best.end(), m_better);
+                m_best.pop_back();
+            }
+        }
+        [[nodiscard]] vector<VALUE> take()
+        {
+            std::sort_heap(m_best.begin(), m_best.end(), m_better);
+            return std::move(m_best);
+        }
+
+        best_of(std::size_t const count, std::size_t const available, BETTER const& better)
+            : m_count(count)
+            , m_better(better)
+        {
+            m_best.reserve(std::min(count, available) + 1);
+        }
+
+    private:
+        std::size_t m_count;
+        BETTER m_better;
+        vector<VALUE> m_best{};
+    };
+}
+
+namespace snapshot::model
+{
+
+allocation_query& allocation_query::where_module(string_view const module)
+{
+    m_module = m_traces != nullptr ? m_traces->find_module(module).value_or(NO_MODULE) : NO_MODULE;
+    m_module_totals_valid = false;
+    return *this;
+}
+
+allocation_query& allocation_query::where_function(string_view const text)
+{
+    m_function = std::string(text);
+    m_module_totals_valid = false;
+    return *this;
+}
+
+vector<allocation_change> allocation_query::top(std::size_t const count, allocation_order const order) const
+{
+    // equal values rank by trace so results do not depend on row order
+    auto const better = [order](allocation_change const& left, allocation_change const& right) {
+        return ranks_above(left, right, order) || (!ranks_above(right, left, order) && left.trace < right.trace);
+    };
+    best_of<allocation_change, decltype(better)> best(count, m_trace_ids.size(), better);
+
+    auto const frames = matching_frames();
+    for (std::size_t index = 0; index < m_trace_ids.size(); index++) {
+        if (!matches(index, frames))
+            continue;
+        auto const change = row(index);
+        if (order == allocation_order::GROWTH && change.bytes_delta <= 0)
+            continue;
+        best.offer(change);
+    }
+    return best.take();
+}
+
+vector<module_total> allocation_query::by_module(allocation_order const order, std::size_t const count) const
+{
+    auto const& totals = module_totals();
+    auto const better = [order](module_total const& left, module_total const& right) {
+        return ranks_above(left, right, order) || (!ranks_above(right, left, order) && left.module < right.module);
+    };
+    best_of<module_total, decltype(better)> best(count, totals.size(), better);
+
+    for (auto const& total : totals) {
+        if (total.traces == 0 || (order == allocation_order::GROWTH && total.bytes_delta <= 0))
+            continue;
+        best.offer(total);
+    }
+    return best.take();
+}
+
+allocation_query::allocation_query(heap_snapshot const& snapshot)
+    : m_traces(snapshot.traces)
+    , m_trace_ids(snapshot.trace_ids)
+    , m_bytes(snapshot.bytes)
+    , m_counts(snapshot.counts)
+    , m_rollups(snapshot.modules)
+{
+}
+
+allocation_query::allocation_query(snapshot_diff const& diff)
+    : m_traces(diff.traces)
+    , m_trace_ids(diff.trace_ids)
+    , m_bytes(diff.bytes)
+    , m_counts(diff.counts)
+    , m_bytes_deltas(diff.bytes_deltas)
+    , m_count_deltas(diff.count_deltas)
+{
+}
+
+allocation_change allocation_query::row(std::size_t const index) const noexcept
+{
+    allocation_change change{};
+    change.trace = m_trace_ids[index];
+    change.bytes = m_bytes[index];
+    change.count = m_counts[index];
+    change.bytes_delta = m_bytes_deltas.empty() ? static_cast<std::int64_t>(change.bytes) : m_bytes_deltas[index];
+    change.count_delta = m_count_deltas.empty() ? static_cast<std::int64_t>(change.count) : m_count_deltas[index];
+    return change;
+}
+
+vector<bool> allocation_query::matching_frames() const
+{
+    vector<bool> frames{};
+    if (!m_function.has_value() || m_traces == nullptr)
+        return frames;
+
+    frames.resize(m_traces->frame_count());
+    for (frame_id frame = 0; frame < frames.size(); frame++)
+        frames[frame] = function_name(m_traces->frame(frame)).find(m_function.value()) != string_view::npos;
+    return frames;
+}
+
+bool allocation_query::matches(std::size_t const index, vector<bool> const& frames) const noexcept
+{
+    if (m_traces == nullptr)
+        return !m_module.has_value() && !m_function.has_value();
+
+    auto const trace = m_trace_ids[index];
+    if (m_module.has_value() && m_traces->module_of(trace) != m_module.value())
+        return false;
+    if (!m_function.has_value())
+        return true;
+
+    auto const trace_frames = m_traces->trace(trace);
+    return std::any_of(trace_frames.begin(), trace_frames.end(), [&frames](frame_id const frame) {
+        return frames[frame];
+    });
+}
+
+vector<module_total> const& allocation_query::module_totals() const
+{
+    if (m_module_totals_valid)
+        return m_module_totals;
+
+    m_module_totals.assign(m_traces != nullptr ? m_traces->module_count() : 0, module_total{});
+    for (module_id module = 0; module < m_module_totals.size(); module++)
+        m_module_totals[module].module = module;
+
+    if (!m_module.has_value() && !m_function.has_value() && !m_rollups.empty()) {
+        for (auto const& rollup : m_rollups) {
+            m_module_totals[rollup.module] = module_total{rollup.module, rollup.bytes, rollup.count,
+                static_cast<std::int64_t>(rollup.bytes), static_cast<std::int64_t>(rollup.count), rollup.traces};
+        }
+        m_module_totals_valid = true;
+        return m_module_totals;
+    }
+
+    auto const frames = matching_frames();
+    for (std::size_t index = 0; index < m_trace_ids.size() && !m_module_totals.empty(); index++) {
+        if (!matches(index, frames))
+            continue;
+        auto const change = row(index);
+        auto& total = m_module_totals[m_traces->module_of(change.trace)];
+        total.bytes += change.bytes;
+        total.count += change.count;
+        total.bytes_delta += change.bytes_delta;
+        total.count_delta += change.count_delta;
+        total.traces++;
+    }
+    m_module_totals_valid = true;
+    return m_module_totals;
+}
+
+}
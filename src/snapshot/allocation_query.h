@@ -0,0 +1,88 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/trace_id.h"
+#include "heap_snapshot.h"
+#include "snapshot_diff.h"
+#include "trace_store.h"
+
+namespace snapshot::model
+{
+    /// <summary>value rows and modules are ranked by</summary>
+    enum class allocation_order
+    {
+        BYTES,
+        COUNT,
+        GROWTH,
+    };
+
+    /// <summary>filtered and ranked view over the rows of a snapshot or diff</summary>
+    /// <remarks>
+    /// filters only record what to match and nothing is evaluated until top or by_module, which walk the
+    /// rows once keeping the best count in a bounded heap, so answering a top 50 never sorts millions of
+    /// rows. the function filter is matched once per distinct frame rather than once per row. unfiltered
+    /// module totals of a snapshot come from the rollup made as it was loaded, other totals are kept after
+    /// the first by_module, so either way repeated groupings cost O(modules). a snapshot is treated
+    /// as growth from nothing, so its GROWTH is its size. the source must outlive the query
+    /// </remarks>
+    class allocation_query final
+    {
+    public:
+        /// <summary>keeps rows attributed to module, ignoring ASCII case</summary>
+        SNAPSHOT_DLL allocation_query& where_module(std::string_view const module);
+        /// <summary>keeps rows with a frame whose function name contains text</summary>
+        SNAPSHOT_DLL allocation_query& where_function(std::string_view const text);
+
+        /// <summary>returns up to count matching rows with the largest order, largest first</summary>
+        /// <remarks>ranking by GROWTH leaves out rows which did not grow</remarks>
+        [[nodiscard]] SNAPSHOT_DLL std::vector<allocation_change> top(std::size_t const count, allocation_order const order) const;
+        /// <summary>totals matching rows per module, returning up to count modules with the largest order, largest first</summary>
+        /// <remarks>ranking by GROWTH leaves out modules which did not grow</remarks>
+        [[nodiscard]] SNAPSHOT_DLL std::vector<module_total> by_module(allocation_order const order, std::size_t const count = std::numeric_limits<std::size_t>::max()) const;
+
+        SNAPSHOT_DLL explicit allocation_query(heap_snapshot const& snapshot);
+        SNAPSHOT_DLL explicit allocation_query(snapshot_diff const& diff);
+
+    private:
+        static constexpr module_id NO_MODULE = std::numeric_limits<module_id>::max();
+
+        std::shared_ptr<trace_store const> m_traces;
+        std::span<trace_id const> m_trace_ids;
+        std::span<std::uint64_t const> m_bytes;
+        std::span<std::uint64_t const> m_counts;
+        std::span<std::int64_t const> m_bytes_deltas{};
+        std::span<std::int64_t const> m_count_deltas{};
+        std::span<module_rollup const> m_rollups{};
+        std::optional<module_id> m_module{};
+        std::optional<std::string> m_function{};
+        mutable std::vector<module_total> m_module_totals{};
+        mutable bool m_module_totals_valid{};
+
+        [[nodiscard]] allocation_change row(std::size_t const index) const noexcept;
+        [[nodiscard]] std::vector<bool> matching_frames() const;
+        [[nodiscard]] bool matches(std::size_t const index, std::vector<bool> const& frames) const noexcept;
+        [[nodiscard]] std::vector<module_total> const& module_totals() const;
+    };
+
+}
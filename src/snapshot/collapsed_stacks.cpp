@@ -0,0 +1,106 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "collapsed_stacks.h"
+#include "frame_text.h"
+
+using std::span;
+using std::string_view;
+
+using snapshot::infrastructure::function_name;
+using snapshot::infrastructure::module_name;
+
+namespace
+{
+    constexpr string_view UNKNOWN_STACK = "[unknown]";
+
+    /// <summary>writes text with the characters collapsed stacks use as separators replaced</summary>
+    void write_escaped(std::ostream& stream, string_view text)
+    {
+        for (auto separator = text.find(';'); separator != string_view::npos; separator = text.find(';')) {
+            stream.write(text.data(), static_cast<std::streamsize>(separator));
+            stream.put(':');
+            text.remove_prefix(separator + 1);
+        }
+        stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    void write_frame(std::ostream& stream, string_view const frame)
+    {
+        auto const module = module_name(frame);
+        if (module.empty()) {
+            write_escaped(stream, frame);
+            return;
+        }
+        write_escaped(stream, module);
+        stream.put('!');
+        write_escaped(stream, function_name(frame));
+    }
+
+    void write_stack(std::ostream& stream, snapshot::model::trace_store const& traces, snapshot::model::trace_id const trace, std::uint64_t const weight)
+    {
+        // the store keeps frames innermost first, flame graphs want the root first
+        auto const frames = traces.trace(trace);
+        if (frames.empty())
+            write_escaped(stream, UNKNOWN_STACK);
+        for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+            if (frame != frames.rbegin())
+                stream.put(';');
+            write_frame(stream, traces.frame(*frame));
+        }
+
+        char digits[24]{};
+        auto const end = std::to_chars(std::begin(digits), std::end(digits), weight).ptr;
+        stream.put(' ');
+        stream.write(digits, end - digits);
+        stream.put('\n');
+    }
+}
+
+namespace snapshot::model
+{
+
+std::size_t write_collapsed_stacks(std::ostream& stream, heap_snapshot const& snapshot, stack_weight const weight)
+{
+    if (snapshot.traces == nullptr)
+        return 0;
+
+    auto const& weights = weight == stack_weight::COUNT ? snapshot.counts : snapshot.bytes;
+    std::size_t lines{};
+    for (std::size_t row = 0; row < snapshot.size(); row++) {
+        if (weights[row] == 0)
+            continue;
+        write_stack(stream, *snapshot.traces, snapshot.trace_ids[row], weights[row]);
+        lines++;
+    }
+    return lines;
+}
+
+std::size_t write_collapsed_stacks(std::ostream& stream, snapshot_diff const& diff, stack_weight const weight)
+{
+    if (diff.traces == nullptr)
+        return 0;
+
+    auto const& weights = weight == stack_weight::COUNT ? diff.count_deltas : diff.bytes_deltas;
+    std::size_t lines{};
+    for (std::size_t row = 0; row < diff.size(); row++) {
+        if (weights[row] <= 0)
+            continue;
+        write_stack(stream, *diff.traces, diff.trace_ids[row], static_cast<std::uint64_t>(weights[row]));
+        lines++;
+    }
+    return lines;
+}
+
+}
@@ -0,0 +1,45 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include "snapshot/snapshot_export.h"
+#include "heap_snapshot.h"
+#include "snapshot_diff.h"
+
+namespace snapshot::model
+{
+    /// <summary>value each collapsed stack is weighted by</summary>
+    enum class stack_weight
+    {
+        BYTES,
+        COUNT,
+    };
+
+    /// <summary>writes snapshot in the collapsed stack format read by flame graph tools</summary>
+    /// <remarks>
+    /// one line per backtrace, frames outermost first joined by semicolons then a space and the weight.
+    /// frames are written as module!function without offsets so every call site in a function shares a
+    /// box. each frame is written straight from the trace_store, nothing is joined per backtrace, so
+    /// memory does not grow with the number of rows; rows with no weight are left out
+    /// </remarks>
+    /// <returns>number of lines written</returns>
+    SNAPSHOT_DLL std::size_t write_collapsed_stacks(std::ostream& stream, heap_snapshot const& snapshot, stack_weight const weight = stack_weight::BYTES);
+    /// <summary>writes the growth in diff in the collapsed stack format read by flame graph tools</summary>
+    /// <remarks>rows are weighted by their increase, those which did not grow are left out</remarks>
+    /// <returns>number of lines written</returns>
+    SNAPSHOT_DLL std::size_t write_collapsed_stacks(std::ostream& stream, snapshot_diff const& diff, stack_weight const weight = stack_weight::BYTES);
+
+}
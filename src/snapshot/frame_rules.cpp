@@ -0,0 +1,204 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "frame_rules.h"
+#include <stdexcept>
+#include "frame_text.h"
+
+using std::span;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using snapshot::infrastructure::equal_ignoring_case;
+using snapshot::infrastructure::fold_case;
+using snapshot::infrastructure::function_name;
+using snapshot::infrastructure::module_name;
+
+namespace
+{
+    constexpr string_view ANY = "*";
+
+    /// <summary>modules whose frames are the heap and CRT allocation paths rather than the code allocating</summary>
+    constexpr string_view ALLOCATOR_MODULES[]{
+        "ntdll", "kernelbase", "kernel32", "ucrtbase", "ucrtbased", "msvcrt", "vcruntime140", "vcruntime140d"
+    };
+    constexpr string_view ALLOCATOR_FRAMES[]{
+        "ntdll!RtlpAllocateHeapInternal", "ntdll!RtlpAllocateHeap", "ntdll!RtlAllocateHeap", "ntdll!RtlDebugAllocateHeap",
+        "ntdll!RtlpReAllocateHeapInternal", "ntdll!RtlReAllocateHeap", "KERNELBASE!LocalAlloc", "KERNELBASE!GlobalAlloc",
+        "kernel32!HeapAlloc", "ucrtbase!_malloc_base", "ucrtbase!malloc", "ucrtbase!_calloc_base", "ucrtbase!calloc",
+        "ucrtbase!_realloc_base", "ucrtbase!realloc", "ucrtbased!heap_alloc_dbg", "ucrtbased!_malloc_dbg", "ucrtbased!malloc",
+        "msvcrt!malloc", "msvcrt!calloc", "msvcrt!realloc", "operator new", "operator new[]",
+    };
+
+    [[nodiscard]] constexpr bool in_allocator_module(string_view const module) noexcept
+    {
+        return std::any_of(std::begin(ALLOCATOR_MODULES), std::end(ALLOCATOR_MODULES), [module](string_view const allocator) {
+            return equal_ignoring_case(module, allocator);
+        });
+    }
+
+    // a stripped frame in a module which is not an allocator module would be stripped yet still blamed
+    static_assert(std::all_of(std::begin(ALLOCATOR_FRAMES), std::end(ALLOCATOR_FRAMES), [](string_view const frame) {
+        return module_name(frame).empty() || in_allocator_module(module_name(frame));
+    }), "every module named by ALLOCATOR_FRAMES must be in ALLOCATOR_MODULES");
+
+    [[nodiscard]] string exact_key(string_view const module, string_view const function)
+    {
+        auto key = fold_case(module);
+        key.push_back('!');
+        key.append(function);
+        return key;
+    }
+}
+
+namespace snapshot::model
+{
+
+frame_rules& frame_rules::strip(span<string_view const> const patterns)
+{
+    if (patterns.empty())
+        throw std::invalid_argument("strip rule has no frames");
+    insert(m_strip, patterns);
+    return *this;
+}
+
+frame_rules& frame_rules::collapse(span<string_view const> const patterns)
+{
+    if (patterns.size() < 2)
+        throw std::invalid_argument("collapse rule needs at least two frames");
+    insert(m_collapse, patterns);
+    return *this;
+}
+
+frame_rules::token frame_rules::classify(string_view const frame) const
+{
+    auto const module = module_name(frame);
+    if (module.empty() || empty())
+        return NO_TOKEN;
+
+    auto const function = function_name(frame);
+    if (auto const exact = m_exact.find(exact_key(module, function)); exact != m_exact.end())
+        return exact->second;
+    if (auto const any_function = m_modules.find(fold_case(module)); any_function != m_modules.end())
+        return any_function->second;
+    if (auto const any_module = m_functions.find(string(function)); any_module != m_functions.end())
+        return any_module->second;
+    return NO_TOKEN;
+}
+
+bool frame_rules::apply(span<frame_id const> const frames, span<token const> const tokens, vector<frame_id>& result) const
+{
+    result.assign(frames.begin(), frames.end());
+    auto rewritten = false;
+    for (auto changed = true; changed;) {
+        changed = false;
+        while (result.size() > 1) {
+            auto const length = longest_match(m_strip, span<frame_id const>(result).first(result.size() - 1), tokens);
+            if (length == 0)
+                break;
+            result.erase(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(length));
+            changed = true;
+        }
+        for (std::size_t start = 0; start < result.size(); start++) {
+            auto const length = longest_match(m_collapse, span<frame_id const>(result).subspan(start), tokens);
+            if (length == 0)
+                continue;
+            auto const first = result.begin() + static_cast<std::ptrdiff_t>(start);
+            result.erase(first, first + static_cast<std::ptrdiff_t>(length - 1));
+            changed = true;
+        }
+        rewritten = rewritten || changed;
+    }
+    return rewritten;
+}
+
+bool frame_rules::empty() const noexcept
+{
+    return m_strip.front().children.empty() && m_collapse.front().children.empty();
+}
+
+frame_rules frame_rules::allocators()
+{
+    frame_rules rules{};
+    for (auto const& frame : ALLOCATOR_FRAMES)
+        rules.strip(span<string_view const>(&frame, 1));
+    return rules;
+}
+
+bool frame_rules::is_allocator_module(string_view const module) noexcept
+{
+    return in_allocator_module(module);
+}
+
+frame_rules::token frame_rules::intern_pattern(string_view const pattern)
+{
+    auto const separator = pattern.find('!');
+    auto const module = separator == string_view::npos ? ANY : pattern.substr(0, separator);
+    auto const function = separator == string_view::npos ? pattern : pattern.substr(separator + 1);
+    if (module.empty() || function.empty() || (module == ANY && function == ANY))
+        throw std::invalid_argument("frame pattern must name a module or a function");
+
+    auto& tokens = module == ANY ? m_functions : function == ANY ? m_modules : m_exact;
+    auto key = module == ANY ? string(function) : function == ANY ? fold_case(module) : exact_key(module, function);
+    auto const existing = tokens.find(key);
+    if (existing != tokens.end())
+        return existing->second;
+    tokens.emplace(std::move(key), ++m_last_token);
+    return m_last_token;
+}
+
+void frame_rules::insert(vector<node>& trie, span<string_view const> const patterns)
+{
+    std::uint32_t current{};
+    for (auto const pattern : patterns) {
+        auto const value = intern_pattern(pattern);
+        auto& children = trie[current].children;
+        auto child = std::lower_bound(children.begin(), children.end(), value, [](auto const& entry, token const key) {
+            return entry.first < key;
+        });
+        if (child == children.end() || child->first != value) {
+            auto const next = static_cast<std::uint32_t>(trie.size());
+            children.insert(child, {value, next});
+            trie.emplace_back();
+            current = next;
+        } else {
+            current = child->second;
+        }
+    }
+    trie[current].terminal = true;
+}
+
+std::size_t frame_rules::longest_match(vector<node> const& trie, span<frame_id const> const frames, span<token const> const tokens) noexcept
+{
+    std::size_t longest{};
+    std::uint32_t current{};
+    for (std::size_t depth = 0; depth < frames.size(); depth++) {
+        auto const value = tokens[frames[depth]];
+        if (value == NO_TOKEN)
+            break;
+        auto const& children = trie[current].children;
+        auto const child = std::lower_bound(children.begin(), children.end(), value, [](auto const& entry, token const key) {
+            return entry.first < key;
+        });
+        if (child == children.end() || child->first != value)
+            break;
+        current = child->second;
+        if (trie[current].terminal)
+            longest = depth + 1;
+    }
+    return longest;
+}
+
+}
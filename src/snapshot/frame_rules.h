@@ -0,0 +1,86 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/trace_id.h"
+
+namespace snapshot::model
+{
+    /// <summary>rewrites backtraces by stripping leading allocator frames and collapsing runs of frames</summary>
+    /// <remarks>
+    /// patterns are module!function where either side may be * to match any module or function, a pattern
+    /// without a module matches the function in any module; modules compare ignoring ASCII case and frame
+    /// offsets are ignored. each distinct pattern becomes a token and the rules of each action are compiled
+    /// into a prefix trie over tokens, so once every distinct frame has been classified to a token,
+    /// rewriting a backtrace walks its frame ids without reading any text. a frame takes the token of the
+    /// most specific pattern it matches, module!function before module!* before *!function. rules are
+    /// applied until none matches, so rewriting a backtrace a second time changes nothing
+    /// </remarks>
+    class frame_rules final
+    {
+    public:
+        using token = std::uint32_t;
+        /// <summary>token of frames matching no pattern</summary>
+        static constexpr token NO_TOKEN = 0;
+
+        /// <summary>removes frames matching patterns, innermost first, from the start of backtraces</summary>
+        /// <remarks>the outermost frame is never stripped, so no backtrace is left empty</remarks>
+        /// <exception cref="std::invalid_argument">when patterns is empty or a pattern is malformed</exception>
+        SNAPSHOT_DLL frame_rules& strip(std::span<std::string_view const> const patterns);
+        /// <summary>replaces frames matching patterns anywhere in a backtrace with the last, outermost, of them</summary>
+        /// <exception cref="std::invalid_argument">when there are fewer than two patterns or a pattern is malformed</exception>
+        SNAPSHOT_DLL frame_rules& collapse(std::span<std::string_view const> const patterns);
+
+        /// <summary>token of the most specific pattern frame matches, or NO_TOKEN</summary>
+        [[nodiscard]] SNAPSHOT_DLL token classify(std::string_view const frame) const;
+        /// <summary>writes frames rewritten by the rules to result</summary>
+        /// <param name="tokens">token of each frame, indexed by frame id</param>
+        /// <returns>false when no rule matched, leaving result holding frames unchanged</returns>
+        [[nodiscard]] SNAPSHOT_DLL bool apply(std::span<frame_id const> const frames, std::span<token const> const tokens, std::vector<frame_id>& result) const;
+        [[nodiscard]] SNAPSHOT_DLL bool empty() const noexcept;
+
+        /// <summary>strip rules for the windows heap, the CRT allocation functions and operator new</summary>
+        [[nodiscard]] SNAPSHOT_DLL static frame_rules allocators();
+        /// <summary>true for the heap and CRT modules allocators() strips from, whose frames are never blamed for an allocation</summary>
+        [[nodiscard]] SNAPSHOT_DLL static bool is_allocator_module(std::string_view const module) noexcept;
+
+    private:
+        struct node
+        {
+            /// <summary>child node by token, in ascending token order</summary>
+            std::vector<std::pair<token, std::uint32_t>> children{};
+            bool terminal{};
+        };
+
+        std::unordered_map<std::string, token> m_exact{};
+        std::unordered_map<std::string, token> m_modules{};
+        std::unordered_map<std::string, token> m_functions{};
+        token m_last_token{NO_TOKEN};
+        std::vector<node> m_strip{node{}};
+        std::vector<node> m_collapse{node{}};
+
+        [[nodiscard]] token intern_pattern(std::string_view const pattern);
+        void insert(std::vector<node>& trie, std::span<std::string_view const> const patterns);
+        [[nodiscard]] static std::size_t longest_match(std::vector<node> const& trie, std::span<frame_id const> const frames, std::span<token const> const tokens) noexcept;
+    };
+
+}
@@ -0,0 +1,65 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+namespace snapshot::infrastructure
+{
+    /// <summary>module of a umdh frame such as ntdll!RtlAllocateHeap+00000020, empty for unsymbolized frames</summary>
+    [[nodiscard]] constexpr std::string_view module_name(std::string_view const frame) noexcept
+    {
+        auto const separator = frame.find('!');
+        return separator == std::string_view::npos ? std::string_view{} : frame.substr(0, separator);
+    }
+
+    /// <summary>function of a umdh frame without its module or trailing hexadecimal offset, empty for unsymbolized frames</summary>
+    [[nodiscard]] inline std::string_view function_name(std::string_view const frame) noexcept
+    {
+        auto const separator = frame.find('!');
+        if (separator == std::string_view::npos)
+            return {};
+
+        auto function = frame.substr(separator + 1);
+        if (auto const offset = function.rfind('+'); offset != std::string_view::npos && offset + 1 < function.size() &&
+            function.find_first_not_of("0123456789abcdefABCDEFx", offset + 1) == std::string_view::npos)
+            function = function.substr(0, offset);
+        return function;
+    }
+
+    [[nodiscard]] constexpr char fold_case(char const value) noexcept
+    {
+        return value >= 'A' && value <= 'Z' ? static_cast<char>(value - 'A' + 'a') : value;
+    }
+
+    /// <summary>compares ignoring ASCII case, which is how module names compare on Windows</summary>
+    [[nodiscard]] constexpr bool equal_ignoring_case(std::string_view const left, std::string_view const right) noexcept
+    {
+        return std::equal(left.begin(), left.end(), right.begin(), right.end(), [](char const l, char const r) {
+            return fold_case(l) == fold_case(r);
+        });
+    }
+
+    [[nodiscard]] inline std::string fold_case(std::string_view const value)
+    {
+        std::string folded(value);
+        std::transform(folded.begin(), folded.end(), folded.begin(), [](char const c) {
+            return fold_case(c);
+        });
+        return folded;
+    }
+
+}
@@ -0,0 +1,102 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "snapshot/trace_id.h"
+#include "trace_store.h"
+
+namespace snapshot::model
+{
+    /// <summary>live allocations made from one backtrace</summary>
+    struct allocation
+    {
+        trace_id trace{};
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+    };
+
+    /// <summary>live allocations attributed to one module, see trace_store::module_of</summary>
+    struct module_rollup
+    {
+        module_id module{};
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        /// <summary>number of backtraces contributing to the totals</summary>
+        std::size_t traces{};
+    };
+
+    /// <summary>allocations at one point in time, one row per backtrace in ascending trace order</summary>
+    /// <remarks>
+    /// rows are stored as parallel columns so passes which only need one of them, such as a diff comparing
+    /// ids before touching sizes, read contiguous memory; backtraces are referenced by id only, the text
+    /// lives once in traces which may be shared by many snapshots. loading totals the rows per module once,
+    /// so module totals cost O(modules) however many backtraces there are
+    /// </remarks>
+    struct heap_snapshot
+    {
+        std::shared_ptr<trace_store const> traces{};
+        std::vector<trace_id> trace_ids{};
+        std::vector<std::uint64_t> bytes{};
+        std::vector<std::uint64_t> counts{};
+        /// <summary>totals per module in ascending module order, empty until roll_up is called</summary>
+        std::vector<module_rollup> modules{};
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return trace_ids.size();
+        }
+        [[nodiscard]] allocation operator[](std::size_t const row) const noexcept
+        {
+            return allocation{trace_ids[row], bytes[row], counts[row]};
+        }
+        /// <summary>adds a row, which must follow every existing row in trace order</summary>
+        void append(allocation const& value)
+        {
+            trace_ids.push_back(value.trace);
+            bytes.push_back(value.bytes);
+            counts.push_back(value.count);
+        }
+        void reserve(std::size_t const rows)
+        {
+            trace_ids.reserve(rows);
+            bytes.reserve(rows);
+            counts.reserve(rows);
+        }
+        /// <summary>replaces modules with the totals of the current rows, which must be interned in traces</summary>
+        void roll_up()
+        {
+            modules.clear();
+            if (traces == nullptr)
+                return;
+
+            std::vector<module_rollup> totals(traces->module_count());
+            for (std::size_t row = 0; row < size(); row++) {
+                auto& total = totals[traces->module_of(trace_ids[row])];
+                total.bytes += bytes[row];
+                total.count += counts[row];
+                total.traces++;
+            }
+            for (module_id module = 0; module < totals.size(); module++) {
+                if (totals[module].traces == 0)
+                    continue;
+                totals[module].module = module;
+                modules.push_back(totals[module]);
+            }
+        }
+    };
+
+}
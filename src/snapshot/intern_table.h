@@ -0,0 +1,85 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace snapshot::infrastructure
+{
+    /// <summary>open addressing hash set of dense ids whose keys are stored by the owner</summary>
+    /// <remarks>
+    /// holding only ids and their hashes keeps the table at 12 bytes per entry plus slack, and since keys
+    /// are compared through the owner they can live in an arena which moves as it grows
+    /// </remarks>
+    class intern_table final
+    {
+    public:
+        /// <summary>returns the id whose key matches, or the id produced by create which must be the next in sequence</summary>
+        /// <exception cref="std::length_error">once 32 bits of ids are exhausted</exception>
+        template <typename MATCHES, typename CREATE>
+        std::uint32_t intern(std::uint64_t const hash, MATCHES&& matches, CREATE&& create)
+        {
+            if ((m_hashes.size() + 1) * 4 > m_slots.size() * 3)
+                grow();
+
+            auto const mask = m_slots.size() - 1;
+            for (auto slot = static_cast<std::size_t>(hash) & mask;; slot = (slot + 1) & mask) {
+                auto const stored = m_slots[slot];
+                if (stored == EMPTY) {
+                    if (m_hashes.size() >= std::numeric_limits<std::uint32_t>::max())
+                        throw std::length_error("intern_table is full");
+                    auto const id = create();
+                    m_hashes.push_back(hash);
+                    m_slots[slot] = id + 1;
+                    return id;
+                }
+                if (auto const id = stored - 1; m_hashes[id] == hash && matches(id))
+                    return id;
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return m_hashes.size();
+        }
+        [[nodiscard]] std::size_t memory_usage() const noexcept
+        {
+            return m_slots.capacity() * sizeof(std::uint32_t) + m_hashes.capacity() * sizeof(std::uint64_t);
+        }
+
+    private:
+        static constexpr std::uint32_t EMPTY = 0;
+        static constexpr std::size_t INITIAL_SLOTS = 1024;
+
+        std::vector<std::uint32_t> m_slots{};
+        std::vector<std::uint64_t> m_hashes{};
+
+        void grow()
+        {
+            std::vector<std::uint32_t> slots(m_slots.empty() ? INITIAL_SLOTS : m_slots.size() * 2, EMPTY);
+            auto const mask = slots.size() - 1;
+            for (std::uint32_t id = 0; id < m_hashes.size(); id++) {
+                auto slot = static_cast<std::size_t>(m_hashes[id]) & mask;
+                while (slots[slot] != EMPTY)
+                    slot = (slot + 1) & mask;
+                slots[slot] = id + 1;
+            }
+            m_slots = std::move(slots);
+        }
+    };
+
+}
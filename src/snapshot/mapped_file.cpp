@@ -0,0 +1,168 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "mapped_file.h"
+#include <system_error>
+
+#ifdef __linux__
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+using std::string_view;
+
+namespace
+{
+    [[noreturn]] void throw_last_error(char const* const operation)
+    {
+#ifdef _WIN32
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), operation);
+#else
+        throw std::system_error(errno, std::generic_category(), operation);
+#endif
+    }
+
+    [[nodiscard]] std::size_t page_size() noexcept
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+}
+
+namespace snapshot::infrastructure
+{
+
+string_view mapped_file::view() const noexcept
+{
+    return string_view(m_data, m_size);
+}
+
+std::size_t mapped_file::size() const noexcept
+{
+    return m_size;
+}
+
+void mapped_file::discard(std::size_t const offset) noexcept
+{
+    static auto const pageSize = page_size();
+    auto const end = std::min(offset, m_size) / pageSize * pageSize;
+    if (m_data == nullptr || end <= m_discarded)
+        return;
+
+    auto* const start = const_cast<char*>(m_data) + m_discarded;
+#ifdef _WIN32
+    // unlocking pages which aren't locked removes them from the working set, which is all we're after
+    VirtualUnlock(start, end - m_discarded);
+#else
+    ::madvise(start, end - m_discarded, MADV_DONTNEED);
+#endif
+    m_discarded = end;
+}
+
+mapped_file::mapped_file(std::filesystem::path const& filename)
+{
+#ifdef _WIN32
+    HANDLE const file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw_last_error("CreateFile");
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw_last_error("GetFileSizeEx");
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    // the view keeps the section alive, so neither handle is needed once it is mapped
+    HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+        throw_last_error("CreateFileMapping");
+    m_data = static_cast<char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (m_data == nullptr)
+        throw_last_error("MapViewOfFile");
+#else
+    auto const file = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        throw_last_error("open");
+
+    struct stat status{};
+    if (::fstat(file, &status) != 0) {
+        ::close(file);
+        throw_last_error("fstat");
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size == 0) {
+        ::close(file);
+        return;
+    }
+
+    auto* const data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED)
+        throw_last_error("mmap");
+    ::madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<char const*>(data);
+#endif
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : m_data{other.m_data}
+    , m_size{other.m_size}
+    , m_discarded{other.m_discarded}
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_discarded = 0;
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_discarded, other.m_discarded);
+    return *this;
+}
+
+mapped_file::~mapped_file()
+{
+    close();
+}
+
+void mapped_file::close() noexcept
+{
+    if (m_data == nullptr)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+}
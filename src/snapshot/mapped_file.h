@@ -0,0 +1,53 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include "snapshot/snapshot_export.h"
+
+namespace snapshot::infrastructure
+{
+    /// <summary>read only view of a whole file mapped into memory</summary>
+    /// <remarks>
+    /// pages are faulted in as they are touched and, being backed by the file, can be dropped again by the
+    /// kernel at no cost; discard lets a forward only reader say so explicitly so a pass over a file much
+    /// larger than memory keeps a bounded working set
+    /// </remarks>
+    class mapped_file final
+    {
+    public:
+        [[nodiscard]] SNAPSHOT_DLL std::string_view view() const noexcept;
+        [[nodiscard]] SNAPSHOT_DLL std::size_t size() const noexcept;
+        /// <summary>hints that the pages wholly before offset won't be read again</summary>
+        SNAPSHOT_DLL void discard(std::size_t const offset) noexcept;
+
+        /// <exception cref="std::system_error">when the file cannot be opened or mapped</exception>
+        SNAPSHOT_DLL explicit mapped_file(std::filesystem::path const& filename);
+        mapped_file(mapped_file const&) = delete;
+        mapped_file& operator=(mapped_file const&) = delete;
+        SNAPSHOT_DLL mapped_file(mapped_file&& other) noexcept;
+        SNAPSHOT_DLL mapped_file& operator=(mapped_file&& other) noexcept;
+        SNAPSHOT_DLL ~mapped_file();
+
+    private:
+        char const* m_data{};
+        std::size_t m_size{};
+        std::size_t m_discarded{};
+
+        void close() noexcept;
+    };
+
+}
@@ -0,0 +1,160 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "parallel_loader.h"
+#include <exception>
+#include <thread>
+#include "mapped_file.h"
+#include "snapshot_builder.h"
+#include "umdh_reader.h"
+
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
+using std::string_view;
+using std::vector;
+
+using snapshot::infrastructure::mapped_file;
+using snapshot::infrastructure::umdh_reader;
+
+namespace
+{
+    /// <summary>pieces smaller than this aren't worth a thread of their own</summary>
+    constexpr std::size_t MINIMUM_CHUNK_SIZE = 1024ULL * 1024ULL;
+
+    struct chunk
+    {
+        string_view text{};
+        snapshot::model::umdh_radix diff_radix{};
+        shared_ptr<snapshot::model::trace_store> traces{};
+        snapshot::model::heap_snapshot snapshot{};
+        std::exception_ptr error{};
+    };
+
+    [[nodiscard]] vector<string_view> split(string_view const text, std::size_t const workers)
+    {
+        auto const count = std::clamp<std::size_t>(text.size() / MINIMUM_CHUNK_SIZE, 1, workers);
+        vector<string_view> pieces{};
+        std::size_t start{};
+        for (std::size_t piece = 1; piece <= count && start < text.size(); piece++) {
+            auto const end = piece == count
+                ? text.size()
+                : std::max(start, umdh_reader::find_record(text, text.size() / count * piece));
+            if (end > start)
+                pieces.push_back(text.substr(start, end - start));
+            start = end;
+        }
+        return pieces;
+    }
+
+    void parse(chunk& piece) noexcept
+    {
+        try {
+            umdh_reader reader(piece.text, piece.diff_radix);
+            snapshot::model::snapshot_builder builder(piece.traces);
+            snapshot::model::umdh_record record{};
+            while (reader.read_next(record))
+                builder.add(record);
+            piece.snapshot = builder.build();
+        } catch (...) {
+            piece.error = std::current_exception();
+        }
+    }
+}
+
+namespace snapshot::model
+{
+
+heap_snapshot load_snapshot_parallel(std::filesystem::path const& filename, shared_ptr<trace_store> traces, std::size_t workers, umdh_radix const diff_radix)
+{
+    if (workers == 0)
+        workers = std::max(1U, std::thread::hardware_concurrency());
+
+    mapped_file const file(filename);
+    auto const pieces = split(file.view(), workers);
+    if (pieces.size() <= 1) {
+        // nothing to merge, so parse straight into traces as load_snapshot does
+        umdh_reader reader(file.view(), diff_radix);
+        snapshot_builder builder(move(traces));
+        umdh_record record{};
+        while (reader.read_next(record))
+            builder.add(record);
+        return builder.build();
+    }
+
+    vector<chunk> chunks{};
+    // chunks rewrite with the same rules so each backtrace is rewritten once, interning the result again changes nothing
+    for (auto const text : pieces)
+        chunks.push_back(chunk{text, diff_radix, make_shared<trace_store>(traces->rules())});
+
+    {
+        vector<std::jthread> threads{};
+        threads.reserve(chunks.size());
+        for (auto& piece : chunks)
+            threads.emplace_back([&piece]() { parse(piece); });
+    }
+    for (auto const& piece : chunks) {
+        if (piece.error)
+            std::rethrow_exception(piece.error);
+    }
+
+    // local ids are in order of first appearance within each chunk, so interning them chunk by chunk
+    // visits frames and backtraces in their order of first appearance in the whole file
+    struct totals
+    {
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        bool seen{};
+    };
+    vector<totals> merged{};
+    vector<frame_id> frames{};
+    vector<frame_id> traceFrames{};
+    vector<trace_id> seen{};
+    for (auto const& piece : chunks) {
+        frames.resize(piece.traces->frame_count());
+        for (frame_id frame = 0; frame < frames.size(); frame++)
+            frames[frame] = traces->intern_frame(piece.traces->frame(frame));
+
+        vector<trace_id> mapped(piece.traces->trace_count());
+        for (trace_id trace = 0; trace < mapped.size(); trace++) {
+            traceFrames.clear();
+            for (auto const frame : piece.traces->trace(trace))
+                traceFrames.push_back(frames[frame]);
+            mapped[trace] = traces->intern_trace(std::span<frame_id const>(traceFrames));
+        }
+
+        merged.resize(traces->trace_count());
+        for (std::size_t row = 0; row < piece.snapshot.size(); row++) {
+            auto const trace = mapped[piece.snapshot.trace_ids[row]];
+            auto& total = merged[trace];
+            if (!total.seen) {
+                total.seen = true;
+                seen.push_back(trace);
+            }
+            total.bytes += piece.snapshot.bytes[row];
+            total.count += piece.snapshot.counts[row];
+        }
+    }
+
+    std::sort(seen.begin(), seen.end());
+    heap_snapshot snapshot{};
+    snapshot.traces = move(traces);
+    snapshot.reserve(seen.size());
+    for (auto const trace : seen)
+        snapshot.append({trace, merged[trace].bytes, merged[trace].count});
+    snapshot.roll_up();
+    return snapshot;
+}
+
+}
@@ -0,0 +1,38 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/umdh_record.h"
+#include "heap_snapshot.h"
+#include "trace_store.h"
+
+namespace snapshot::model
+{
+    /// <summary>as load_snapshot, reading the file on up to workers threads</summary>
+    /// <remarks>
+    /// the mapped file is split at record headers and each piece interned into a private trace_store;
+    /// the pieces are then merged in file order, which interns every frame and backtrace in order of first
+    /// appearance just as a single pass does, so ids and the resulting snapshot are identical to
+    /// load_snapshot whatever the number of workers
+    /// </remarks>
+    /// <param name="workers">upper bound on threads, zero uses one per hardware thread</param>
+    /// <param name="diff_radix">as for load_snapshot</param>
+    /// <exception cref="std::system_error">when the file cannot be opened or mapped</exception>
+    [[nodiscard]] SNAPSHOT_DLL heap_snapshot load_snapshot_parallel(std::filesystem::path const& filename, std::shared_ptr<trace_store> traces, std::size_t workers = 0,
+        umdh_radix const diff_radix = umdh_radix::HEXADECIMAL);
+
+}
@@ -0,0 +1,351 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "snapshot_archive.h"
+#include <limits>
+#include <stdexcept>
+#include "varint.h"
+
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+
+using snapshot::model::frame_rules;
+using snapshot::model::heap_snapshot;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+
+namespace
+{
+    constexpr string_view HEADER_MAGIC{"UMDHARC\x01", 8};
+    constexpr string_view TRAILER_MAGIC{"UMDHIDX\x01", 8};
+    constexpr std::size_t TRAILER_SIZE = sizeof(std::uint64_t) + TRAILER_MAGIC.size();
+
+    [[noreturn]] void throw_corrupt()
+    {
+        throw std::runtime_error("corrupt snapshot archive");
+    }
+
+    [[nodiscard]] std::uint64_t read_or_throw(string_view& input)
+    {
+        std::uint64_t value{};
+        if (!snapshot::infrastructure::read_varint(input, value))
+            throw_corrupt();
+        return value;
+    }
+
+    [[nodiscard]] std::int64_t to_microseconds(std::chrono::system_clock::time_point const value) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(value.time_since_epoch()).count();
+    }
+
+    [[nodiscard]] std::int64_t difference(std::uint64_t const before, std::uint64_t const after) noexcept
+    {
+        return static_cast<std::int64_t>(after) - static_cast<std::int64_t>(before);
+    }
+
+    /// <summary>writes a row unless it is empty, the trace as the gap from the previous row written</summary>
+    class row_encoder final
+    {
+    public:
+        void add_full(trace_id const trace, std::uint64_t const bytes, std::uint64_t const count)
+        {
+            if (bytes == 0 && count == 0)
+                return;
+            add_trace(trace);
+            snapshot::infrastructure::write_varint(m_rows, bytes);
+            snapshot::infrastructure::write_varint(m_rows, count);
+        }
+        void add_delta(trace_id const trace, std::int64_t const bytes, std::int64_t const count)
+        {
+            if (bytes == 0 && count == 0)
+                return;
+            add_trace(trace);
+            snapshot::infrastructure::write_varint(m_rows, snapshot::infrastructure::zigzag_encode(bytes));
+            snapshot::infrastructure::write_varint(m_rows, snapshot::infrastructure::zigzag_encode(count));
+        }
+        void finish(string& block) const
+        {
+            block.clear();
+            snapshot::infrastructure::write_varint(block, m_row_count);
+            block.append(m_rows);
+        }
+
+    private:
+        string m_rows{};
+        std::uint64_t m_row_count{};
+        std::uint64_t m_next_trace{};
+
+        void add_trace(trace_id const trace)
+        {
+            snapshot::infrastructure::write_varint(m_rows, trace - m_next_trace);
+            m_next_trace = static_cast<std::uint64_t>(trace) + 1;
+            m_row_count++;
+        }
+    };
+
+    /// <summary>reads rows written by row_encoder, calling read_row with the trace and the two remaining values</summary>
+    template <typename READ_ROW>
+    void decode_rows(string_view input, READ_ROW&& read_row)
+    {
+        auto const rows = read_or_throw(input);
+        std::uint64_t nextTrace{};
+        for (std::uint64_t row = 0; row < rows; row++) {
+            auto const trace = nextTrace + read_or_throw(input);
+            if (trace > std::numeric_limits<trace_id>::max())
+                throw_corrupt();
+            auto const bytes = read_or_throw(input);
+            auto const count = read_or_throw(input);
+            read_row(static_cast<trace_id>(trace), bytes, count);
+            nextTrace = trace + 1;
+        }
+    }
+}
+
+namespace snapshot::infrastructure
+{
+
+void archive_writer::append(heap_snapshot const& snapshot, time_point const taken)
+{
+    if (snapshot.traces != nullptr && snapshot.traces != m_traces)
+        throw std::invalid_argument("snapshot does not share the trace_store of the archive");
+    if (m_closed)
+        throw std::runtime_error("archive is closed");
+
+    auto const keyframe = m_index.size() % m_keyframe_interval == 0;
+    row_encoder rows{};
+    if (keyframe) {
+        for (std::size_t row = 0; row < snapshot.size(); row++)
+            rows.add_full(snapshot.trace_ids[row], snapshot.bytes[row], snapshot.counts[row]);
+    } else {
+        // same merge join as diff_snapshots, but every change is kept since the reader replays them
+        auto const& before = m_previous;
+        std::size_t left{};
+        std::size_t right{};
+        while (left < before.size() || right < snapshot.size()) {
+            if (right == snapshot.size() || (left < before.size() && before.trace_ids[left] < snapshot.trace_ids[right])) {
+                rows.add_delta(before.trace_ids[left], difference(before.bytes[left], 0ULL), difference(before.counts[left], 0ULL));
+                left++;
+            } else if (left == before.size() || snapshot.trace_ids[right] < before.trace_ids[left]) {
+                rows.add_delta(snapshot.trace_ids[right], difference(0ULL, snapshot.bytes[right]), difference(0ULL, snapshot.counts[right]));
+                right++;
+            } else {
+                rows.add_delta(snapshot.trace_ids[right], difference(before.bytes[left], snapshot.bytes[right]), difference(before.counts[left], snapshot.counts[right]));
+                left++;
+                right++;
+            }
+        }
+    }
+
+    rows.finish(m_buffer);
+    m_index.push_back({m_offset, to_microseconds(taken), keyframe});
+    write(m_buffer);
+    m_previous = snapshot;
+}
+
+void archive_writer::close()
+{
+    if (m_closed)
+        return;
+    m_closed = true;
+
+    auto const dictionaryOffset = m_offset;
+    m_buffer.clear();
+    write_varint(m_buffer, m_traces->frame_count());
+    for (model::frame_id frame = 0; frame < m_traces->frame_count(); frame++) {
+        auto const text = m_traces->frame(frame);
+        write_varint(m_buffer, text.size());
+        m_buffer.append(text);
+    }
+    write_varint(m_buffer, m_traces->trace_count());
+    for (trace_id trace = 0; trace < m_traces->trace_count(); trace++) {
+        auto const frames = m_traces->trace(trace);
+        write_varint(m_buffer, frames.size());
+        for (auto const frame : frames)
+            write_varint(m_buffer, frame);
+    }
+    write(m_buffer);
+
+    auto const indexOffset = m_offset;
+    m_buffer.clear();
+    write_varint(m_buffer, dictionaryOffset);
+    write_varint(m_buffer, m_index.size());
+    for (auto const& entry : m_index) {
+        write_varint(m_buffer, entry.offset);
+        write_varint(m_buffer, zigzag_encode(entry.taken));
+        m_buffer.push_back(entry.keyframe ? '\x01' : '\x00');
+    }
+    for (auto shift = 0; shift < 64; shift += 8)
+        m_buffer.push_back(static_cast<char>((indexOffset >> shift) & 0xFFULL));
+    m_buffer.append(TRAILER_MAGIC);
+    write(m_buffer);
+
+    m_stream.close();
+    if (m_stream.fail())
+        throw std::runtime_error("unable to write snapshot archive");
+}
+
+archive_writer::archive_writer(std::filesystem::path const& filename, shared_ptr<trace_store const> traces, std::size_t const keyframe_interval)
+    : m_stream(filename, std::ios::binary | std::ios::trunc)
+    , m_traces(move(traces))
+    , m_keyframe_interval(std::max<std::size_t>(keyframe_interval, 1))
+{
+    if (!m_stream.is_open())
+        throw std::runtime_error("unable to create " + filename.string());
+    write(string(HEADER_MAGIC));
+}
+
+archive_writer::~archive_writer()
+{
+    try {
+        close();
+    } catch (std::exception const&) {
+        // nothing more can be done with a failed write from a destructor
+    }
+}
+
+void archive_writer::write(string const& data)
+{
+    m_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (m_stream.fail())
+        throw std::runtime_error("unable to write snapshot archive");
+    m_offset += data.size();
+}
+
+std::size_t archive_reader::size() const noexcept
+{
+    return m_index.size();
+}
+
+archive_reader::time_point archive_reader::taken(std::size_t const index) const
+{
+    return time_point(std::chrono::duration_cast<time_point::duration>(std::chrono::microseconds(m_index.at(index).taken)));
+}
+
+heap_snapshot archive_reader::load(std::size_t const index) const
+{
+    auto keyframe = index;
+    while (!m_index.at(keyframe).keyframe) {
+        if (keyframe == 0)
+            throw_corrupt();
+        keyframe--;
+    }
+
+    auto const view = m_file.view();
+    heap_snapshot current{};
+    current.traces = m_traces;
+    decode_rows(view.substr(m_index[keyframe].offset), [&current](trace_id const trace, std::uint64_t const bytes, std::uint64_t const count) {
+        current.append({trace, bytes, count});
+    });
+
+    heap_snapshot next{};
+    next.traces = m_traces;
+    for (auto position = keyframe + 1; position <= index; position++) {
+        next.trace_ids.clear();
+        next.bytes.clear();
+        next.counts.clear();
+        next.reserve(current.size());
+
+        std::size_t row{};
+        auto const apply = [&next](trace_id const trace, std::uint64_t const bytes, std::uint64_t const count) {
+            if (bytes != 0 || count != 0)
+                next.append({trace, bytes, count});
+        };
+        decode_rows(view.substr(m_index[position].offset), [&](trace_id const trace, std::uint64_t const bytes, std::uint64_t const count) {
+            for (; row < current.size() && current.trace_ids[row] < trace; row++)
+                next.append(current[row]);
+            auto const existing = row < current.size() && current.trace_ids[row] == trace;
+            apply(trace,
+                static_cast<std::uint64_t>((existing ? static_cast<std::int64_t>(current.bytes[row]) : 0LL) + zigzag_decode(bytes)),
+                static_cast<std::uint64_t>((existing ? static_cast<std::int64_t>(current.counts[row]) : 0LL) + zigzag_decode(count)));
+            if (existing)
+                row++;
+        });
+        for (; row < current.size(); row++)
+            next.append(current[row]);
+        std::swap(current, next);
+    }
+    current.roll_up();
+    return current;
+}
+
+shared_ptr<trace_store> archive_reader::traces() const noexcept
+{
+    return m_traces;
+}
+
+archive_reader::archive_reader(std::filesystem::path const& filename, frame_rules rules)
+    : m_file(filename)
+    , m_traces(std::make_shared<trace_store>(move(rules)))
+{
+    auto const view = m_file.view();
+    if (view.size() < HEADER_MAGIC.size() + TRAILER_SIZE || !view.starts_with(HEADER_MAGIC) || !view.ends_with(TRAILER_MAGIC))
+        throw std::runtime_error("not a snapshot archive");
+
+    std::uint64_t indexOffset{};
+    auto const trailer = view.substr(view.size() - TRAILER_SIZE);
+    for (auto shift = 0; shift < 64; shift += 8)
+        indexOffset |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(trailer[static_cast<std::size_t>(shift / 8)])) << shift;
+    if (indexOffset > view.size() - TRAILER_SIZE)
+        throw_corrupt();
+
+    auto index = view.substr(indexOffset, view.size() - TRAILER_SIZE - indexOffset);
+    auto const dictionaryOffset = read_or_throw(index);
+    auto const entries = read_or_throw(index);
+    if (dictionaryOffset > indexOffset || entries > index.size())
+        throw_corrupt();
+    m_index.reserve(entries);
+    for (std::uint64_t entry = 0; entry < entries; entry++) {
+        auto const offset = read_or_throw(index);
+        auto const taken = zigzag_decode(read_or_throw(index));
+        if (index.empty() || offset >= dictionaryOffset)
+            throw_corrupt();
+        m_index.push_back({offset, taken, index.front() != '\x00'});
+        index.remove_prefix(1);
+    }
+
+    read_dictionaries(view.substr(dictionaryOffset, indexOffset - dictionaryOffset));
+}
+
+void archive_reader::read_dictionaries(string_view input)
+{
+    // ids are dense in order of first appearance, so interning in written order reproduces them exactly
+    auto const frames = read_or_throw(input);
+    for (std::uint64_t frame = 0; frame < frames; frame++) {
+        auto const length = read_or_throw(input);
+        if (length > input.size() || m_traces->intern_frame(input.substr(0, length)) != frame)
+            throw_corrupt();
+        input.remove_prefix(length);
+    }
+
+    std::vector<model::frame_id> ids{};
+    auto const traces = read_or_throw(input);
+    for (std::uint64_t trace = 0; trace < traces; trace++) {
+        auto const length = read_or_throw(input);
+        if (length > input.size())
+            throw_corrupt();
+        ids.clear();
+        for (std::uint64_t frame = 0; frame < length; frame++) {
+            auto const id = read_or_throw(input);
+            if (id >= frames)
+                throw_corrupt();
+            ids.push_back(static_cast<model::frame_id>(id));
+        }
+        if (m_traces->intern_trace(std::span<model::frame_id const>(ids)) != trace)
+            throw_corrupt();
+    }
+}
+
+}
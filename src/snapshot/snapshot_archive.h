@@ -0,0 +1,121 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "heap_snapshot.h"
+#include "mapped_file.h"
+#include "trace_store.h"
+
+namespace snapshot::infrastructure
+{
+    /// <summary>appends snapshots to a binary archive, storing each as the change from the one before it</summary>
+    /// <remarks>
+    /// rows are (trace gap, bytes, count) varints, with bytes and count zigzag encoded deltas against the
+    /// previous snapshot so unchanged backtraces cost nothing; every keyframe_interval snapshots is stored
+    /// in full so loading one never replays more than that many deltas. frame and backtrace dictionaries
+    /// are written once, on close, followed by an index of snapshot offsets and a fixed size trailer
+    /// pointing at it. rows with zero bytes and count are not stored
+    /// </remarks>
+    class archive_writer final
+    {
+    public:
+        using time_point = std::chrono::system_clock::time_point;
+
+        /// <exception cref="std::invalid_argument">when snapshot was interned into a different trace_store</exception>
+        /// <exception cref="std::runtime_error">when the archive cannot be written</exception>
+        SNAPSHOT_DLL void append(model::heap_snapshot const& snapshot, time_point const taken);
+        /// <summary>writes the dictionaries and index, the archive is unreadable until this is done</summary>
+        /// <exception cref="std::runtime_error">when the archive cannot be written</exception>
+        SNAPSHOT_DLL void close();
+
+        /// <exception cref="std::runtime_error">when the archive cannot be created</exception>
+        SNAPSHOT_DLL archive_writer(std::filesystem::path const& filename, std::shared_ptr<model::trace_store const> traces, std::size_t const keyframe_interval = 16);
+        archive_writer(archive_writer const&) = delete;
+        archive_writer& operator=(archive_writer const&) = delete;
+        archive_writer(archive_writer&&) = delete;
+        archive_writer& operator=(archive_writer&&) = delete;
+        /// <summary>closes the archive if close hasn't been called, discarding any error</summary>
+        SNAPSHOT_DLL ~archive_writer();
+
+    private:
+        struct index_entry
+        {
+            std::uint64_t offset{};
+            std::int64_t taken{};
+            bool keyframe{};
+        };
+
+        std::ofstream m_stream;
+        std::shared_ptr<model::trace_store const> m_traces;
+        std::size_t m_keyframe_interval;
+        std::vector<index_entry> m_index{};
+        model::heap_snapshot m_previous{};
+        std::string m_buffer{};
+        std::uint64_t m_offset{};
+        bool m_closed{};
+
+        void write(std::string const& data);
+    };
+
+    /// <summary>loads snapshots from an archive written by archive_writer</summary>
+    /// <remarks>
+    /// the archive is mapped rather than read so loading a snapshot only touches its nearest keyframe and
+    /// the deltas after it; the dictionaries are interned into a new trace_store up front which every
+    /// loaded snapshot shares, with the same ids they had when written
+    /// </remarks>
+    class archive_reader final
+    {
+    public:
+        using time_point = std::chrono::system_clock::time_point;
+
+        [[nodiscard]] SNAPSHOT_DLL std::size_t size() const noexcept;
+        [[nodiscard]] SNAPSHOT_DLL time_point taken(std::size_t const index) const;
+        /// <exception cref="std::out_of_range">when index is not less than size</exception>
+        /// <exception cref="std::runtime_error">when the snapshot is corrupt</exception>
+        [[nodiscard]] SNAPSHOT_DLL model::heap_snapshot load(std::size_t const index) const;
+        /// <summary>store shared by every loaded snapshot, live snapshots built into it share ids with the archive</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::shared_ptr<model::trace_store> traces() const noexcept;
+
+        /// <param name="rules">
+        /// rules the writer's trace_store was built with; archived backtraces are already rewritten, rules
+        /// applies to backtraces interned into traces afterwards so they are rewritten the same way
+        /// </param>
+        /// <exception cref="std::system_error">when the file cannot be opened or mapped</exception>
+        /// <exception cref="std::runtime_error">when the file is not a complete archive</exception>
+        SNAPSHOT_DLL explicit archive_reader(std::filesystem::path const& filename, model::frame_rules rules = model::frame_rules());
+
+    private:
+        struct index_entry
+        {
+            std::uint64_t offset{};
+            std::int64_t taken{};
+            bool keyframe{};
+        };
+
+        mapped_file m_file;
+        std::vector<index_entry> m_index{};
+        std::shared_ptr<model::trace_store> m_traces{};
+
+        void read_dictionaries(std::string_view input);
+    };
+
+}
@@ -0,0 +1,82 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "snapshot_builder.h"
+#include "umdh_reader.h"
+
+using std::move;
+using std::shared_ptr;
+using std::span;
+using std::string_view;
+
+using snapshot::infrastructure::umdh_file_reader;
+
+namespace snapshot::model
+{
+
+void snapshot_builder::add(umdh_record const& record)
+{
+    auto trace = m_trace_by_backtrace.find(record.backtrace_id);
+    if (trace == m_trace_by_backtrace.end())
+        trace = m_trace_by_backtrace.emplace(record.backtrace_id, m_traces->intern_trace(span<string_view const>(record.frames))).first;
+
+    auto const id = trace->second;
+    if (id >= m_totals.size())
+        m_totals.resize(m_traces->trace_count());
+
+    auto& total = m_totals[id];
+    if (!total.seen) {
+        total.seen = true;
+        m_seen.push_back(id);
+    }
+    total.bytes += record.bytes;
+    total.count += record.count;
+}
+
+heap_snapshot snapshot_builder::build()
+{
+    std::sort(m_seen.begin(), m_seen.end());
+
+    heap_snapshot snapshot{};
+    snapshot.traces = m_traces;
+    snapshot.reserve(m_seen.size());
+    for (auto const id : m_seen) {
+        auto& total = m_totals[id];
+        snapshot.append({id, total.bytes, total.count});
+        total = totals{};
+    }
+    snapshot.roll_up();
+
+    // umdh backtrace ids are only meaningful within the process a log came from
+    m_seen.clear();
+    m_trace_by_backtrace.clear();
+    return snapshot;
+}
+
+snapshot_builder::snapshot_builder(shared_ptr<trace_store> traces)
+    : m_traces(move(traces))
+{
+}
+
+heap_snapshot load_snapshot(std::filesystem::path const& filename, shared_ptr<trace_store> traces, umdh_radix const diff_radix)
+{
+    umdh_file_reader reader(filename, diff_radix);
+    snapshot_builder builder(move(traces));
+    umdh_record record{};
+    while (reader.read_next(record))
+        builder.add(record);
+    return builder.build();
+}
+
+}
@@ -0,0 +1,61 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/umdh_record.h"
+#include "heap_snapshot.h"
+#include "trace_store.h"
+
+namespace snapshot::model
+{
+    /// <summary>interns umdh records into a trace_store and totals them per backtrace</summary>
+    /// <remarks>
+    /// older umdh logs repeat a backtrace for every allocation made from it, so umdh backtrace ids already
+    /// seen in the current snapshot skip interning altogether
+    /// </remarks>
+    class snapshot_builder final
+    {
+    public:
+        SNAPSHOT_DLL void add(umdh_record const& record);
+        /// <summary>returns the snapshot of every record added since the last build</summary>
+        [[nodiscard]] SNAPSHOT_DLL heap_snapshot build();
+
+        SNAPSHOT_DLL explicit snapshot_builder(std::shared_ptr<trace_store> traces);
+
+    private:
+        struct totals
+        {
+            std::uint64_t bytes{};
+            std::uint64_t count{};
+            bool seen{};
+        };
+
+        std::shared_ptr<trace_store> m_traces;
+        std::unordered_map<std::uint64_t, trace_id> m_trace_by_backtrace{};
+        std::vector<totals> m_totals{};
+        std::vector<trace_id> m_seen{};
+    };
+
+    /// <summary>reads every record of a umdh log or diff into a snapshot interned in traces</summary>
+    /// <param name="diff_radix">base of the sizes and counts if filename is a diff, decimal only when umdh was run with -d</param>
+    /// <exception cref="std::system_error">when the file cannot be opened or mapped</exception>
+    [[nodiscard]] SNAPSHOT_DLL heap_snapshot load_snapshot(std::filesystem::path const& filename, std::shared_ptr<trace_store> traces,
+        umdh_radix const diff_radix = umdh_radix::HEXADECIMAL);
+
+}
@@ -0,0 +1,89 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "snapshot_diff.h"
+#include <stdexcept>
+
+using std::vector;
+
+namespace
+{
+    [[nodiscard]] std::int64_t difference(std::uint64_t const before, std::uint64_t const after) noexcept
+    {
+        return static_cast<std::int64_t>(after) - static_cast<std::int64_t>(before);
+    }
+}
+
+namespace snapshot::model
+{
+
+snapshot_diff diff_snapshots(heap_snapshot const& before, heap_snapshot const& after, bool const include_unchanged)
+{
+    if (before.traces != after.traces && before.size() != 0 && after.size() != 0)
+        throw std::invalid_argument("snapshots do not share a trace_store");
+
+    snapshot_diff diff{};
+    diff.traces = after.traces != nullptr ? after.traces : before.traces;
+    diff.reserve(std::max(before.size(), after.size()));
+
+    std::size_t left{};
+    std::size_t right{};
+    while (left < before.size() || right < after.size()) {
+        if (right == after.size() || (left < before.size() && before.trace_ids[left] < after.trace_ids[right])) {
+            diff.append({before.trace_ids[left], 0ULL, 0ULL, difference(before.bytes[left], 0ULL), difference(before.counts[left], 0ULL)});
+            left++;
+        } else if (left == before.size() || after.trace_ids[right] < before.trace_ids[left]) {
+            diff.append({after.trace_ids[right], after.bytes[right], after.counts[right], difference(0ULL, after.bytes[right]), difference(0ULL, after.counts[right])});
+            right++;
+        } else {
+            auto const bytesDelta = difference(before.bytes[left], after.bytes[right]);
+            auto const countDelta = difference(before.counts[left], after.counts[right]);
+            if (include_unchanged || bytesDelta != 0 || countDelta != 0)
+                diff.append({after.trace_ids[right], after.bytes[right], after.counts[right], bytesDelta, countDelta});
+            left++;
+            right++;
+        }
+    }
+    return diff;
+}
+
+vector<module_total> diff_modules(heap_snapshot const& before, heap_snapshot const& after)
+{
+    if (before.traces != nullptr && after.traces != nullptr && before.traces != after.traces)
+        throw std::invalid_argument("snapshots do not share a trace_store");
+
+    vector<module_total> modules{};
+    modules.reserve(std::max(before.modules.size(), after.modules.size()));
+    std::size_t left{};
+    std::size_t right{};
+    while (left < before.modules.size() || right < after.modules.size()) {
+        auto const& earlier = before.modules;
+        auto const& later = after.modules;
+        if (right == later.size() || (left < earlier.size() && earlier[left].module < later[right].module)) {
+            modules.push_back({earlier[left].module, 0ULL, 0ULL, difference(earlier[left].bytes, 0ULL), difference(earlier[left].count, 0ULL), 0ULL});
+            left++;
+        } else if (left == earlier.size() || later[right].module < earlier[left].module) {
+            modules.push_back({later[right].module, later[right].bytes, later[right].count, difference(0ULL, later[right].bytes), difference(0ULL, later[right].count), later[right].traces});
+            right++;
+        } else {
+            modules.push_back({later[right].module, later[right].bytes, later[right].count,
+                difference(earlier[left].bytes, later[right].bytes), difference(earlier[left].count, later[right].count), later[right].traces});
+            left++;
+            right++;
+        }
+    }
+    return modules;
+}
+
+}
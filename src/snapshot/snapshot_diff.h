@@ -0,0 +1,95 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/trace_id.h"
+#include "heap_snapshot.h"
+#include "trace_store.h"
+
+namespace snapshot::model
+{
+    /// <summary>allocations from one backtrace in the later snapshot along with how they changed</summary>
+    struct allocation_change
+    {
+        trace_id trace{};
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        std::int64_t bytes_delta{};
+        std::int64_t count_delta{};
+    };
+
+    /// <summary>allocations attributed to one module in the later snapshot along with how they changed</summary>
+    struct module_total
+    {
+        module_id module{};
+        std::uint64_t bytes{};
+        std::uint64_t count{};
+        std::int64_t bytes_delta{};
+        std::int64_t count_delta{};
+        /// <summary>number of backtraces contributing to the totals</summary>
+        std::size_t traces{};
+    };
+
+    /// <summary>growth between two snapshots, one row per backtrace in ascending trace order</summary>
+    /// <remarks>backtraces freed entirely appear with zero bytes and negative deltas</remarks>
+    struct snapshot_diff
+    {
+        std::shared_ptr<trace_store const> traces{};
+        std::vector<trace_id> trace_ids{};
+        std::vector<std::uint64_t> bytes{};
+        std::vector<std::uint64_t> counts{};
+        std::vector<std::int64_t> bytes_deltas{};
+        std::vector<std::int64_t> count_deltas{};
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return trace_ids.size();
+        }
+        [[nodiscard]] allocation_change operator[](std::size_t const row) const noexcept
+        {
+            return allocation_change{trace_ids[row], bytes[row], counts[row], bytes_deltas[row], count_deltas[row]};
+        }
+        /// <summary>adds a row, which must follow every existing row in trace order</summary>
+        void append(allocation_change const& value)
+        {
+            trace_ids.push_back(value.trace);
+            bytes.push_back(value.bytes);
+            counts.push_back(value.count);
+            bytes_deltas.push_back(value.bytes_delta);
+            count_deltas.push_back(value.count_delta);
+        }
+        void reserve(std::size_t const rows)
+        {
+            trace_ids.reserve(rows);
+            bytes.reserve(rows);
+            counts.reserve(rows);
+            bytes_deltas.reserve(rows);
+            count_deltas.reserve(rows);
+        }
+    };
+
+    /// <summary>compares two snapshots with a single merge join over their trace ordered rows</summary>
+    /// <param name="include_unchanged">keeps rows whose bytes and count are the same in both snapshots</param>
+    /// <exception cref="std::invalid_argument">when the snapshots were not interned into the same trace_store</exception>
+    [[nodiscard]] SNAPSHOT_DLL snapshot_diff diff_snapshots(heap_snapshot const& before, heap_snapshot const& after, bool const include_unchanged = false);
+    /// <summary>compares the module rollups of two snapshots, one entry per module in either in ascending module order</summary>
+    /// <remarks>costs O(modules), the per backtrace rows are not visited</remarks>
+    /// <exception cref="std::invalid_argument">when the snapshots were not interned into the same trace_store</exception>
+    [[nodiscard]] SNAPSHOT_DLL std::vector<module_total> diff_modules(heap_snapshot const& before, heap_snapshot const& after);
+
+}
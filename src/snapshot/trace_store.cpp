@@ -0,0 +1,216 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "trace_store.h"
+#include "frame_text.h"
+
+using std::nullopt;
+using std::optional;
+using std::span;
+using std::string;
+using std::string_view;
+
+using snapshot::infrastructure::equal_ignoring_case;
+using snapshot::infrastructure::module_name;
+
+namespace
+{
+    [[nodiscard]] std::uint64_t hash_frames(span<snapshot::model::frame_id const> const frames) noexcept
+    {
+        // FNV-1a over whole ids, finished with a multiply so the low bits used for slots depend on every frame
+        auto hash = 14695981039346656037ULL;
+        for (auto const frame : frames)
+            hash = (hash ^ frame) * 1099511628211ULL;
+        return (hash ^ (hash >> 29)) * 0xBF58476D1CE4E5B9ULL;
+    }
+}
+
+namespace snapshot::model
+{
+
+frame_id trace_store::intern_frame(string_view const frame)
+{
+    auto const hash = static_cast<std::uint64_t>(std::hash<string_view>()(frame));
+    return m_frames.intern(hash,
+        [this, frame](frame_id const id) {
+            return this->frame(id) == frame;
+        },
+        [this, frame]() {
+            m_frame_text.insert(m_frame_text.end(), frame.begin(), frame.end());
+            m_frame_offsets.push_back(m_frame_text.size());
+            m_frame_modules.push_back(intern_module(frame));
+            if (!m_rules.empty())
+                m_frame_tokens.push_back(m_rules.classify(frame));
+            return static_cast<frame_id>(m_frame_offsets.size() - 2);
+        });
+}
+
+trace_id trace_store::intern_trace(span<frame_id const> const frames)
+{
+    if (m_rules.empty())
+        return intern_rewritten(frames);
+
+    // the rules run once per distinct backtrace as given, repeats are a lookup of what it was rewritten to
+    auto const original = m_original_traces.intern(hash_frames(frames),
+        [this, frames](std::uint32_t const id) {
+            auto const existing = original_frames(id);
+            return std::equal(existing.begin(), existing.end(), frames.begin(), frames.end());
+        },
+        [this, frames]() {
+            original_trace entry{};
+            if (m_rules.apply(frames, m_frame_tokens, m_rewritten)) {
+                entry.rewritten = intern_rewritten(m_rewritten);
+                entry.begin = m_original_frames.size();
+                m_original_frames.insert(m_original_frames.end(), frames.begin(), frames.end());
+                entry.end = m_original_frames.size();
+            } else {
+                entry.rewritten = intern_rewritten(frames);
+            }
+            m_originals.push_back(entry);
+            return static_cast<std::uint32_t>(m_originals.size() - 1);
+        });
+    return m_originals[original].rewritten;
+}
+
+trace_id trace_store::intern_rewritten(span<frame_id const> const frames)
+{
+    return m_traces.intern(hash_frames(frames),
+        [this, frames](trace_id const id) {
+            auto const existing = trace(id);
+            return std::equal(existing.begin(), existing.end(), frames.begin(), frames.end());
+        },
+        [this, frames]() {
+            m_trace_frames.insert(m_trace_frames.end(), frames.begin(), frames.end());
+            m_trace_offsets.push_back(m_trace_frames.size());
+            m_trace_modules.push_back(attribute(frames));
+            return static_cast<trace_id>(m_trace_offsets.size() - 2);
+        });
+}
+
+trace_id trace_store::intern_trace(span<string_view const> const frames)
+{
+    m_interned.clear();
+    for (auto const frame : frames)
+        m_interned.push_back(intern_frame(frame));
+    return intern_trace(span<frame_id const>(m_interned));
+}
+
+string_view trace_store::frame(frame_id const id) const noexcept
+{
+    return string_view(m_frame_text.data() + m_frame_offsets[id], m_frame_offsets[id + 1] - m_frame_offsets[id]);
+}
+
+span<frame_id const> trace_store::trace(trace_id const id) const noexcept
+{
+    return span<frame_id const>(m_trace_frames.data() + m_trace_offsets[id], m_trace_offsets[id + 1] - m_trace_offsets[id]);
+}
+
+module_id trace_store::frame_module(frame_id const id) const noexcept
+{
+    return m_frame_modules[id];
+}
+
+module_id trace_store::module_of(trace_id const id) const noexcept
+{
+    return m_trace_modules[id];
+}
+
+string_view trace_store::module(module_id const id) const noexcept
+{
+    return m_module_names[id];
+}
+
+optional<module_id> trace_store::find_module(string_view const name) const noexcept
+{
+    if (auto const exact = m_module_by_name.find(name); exact != m_module_by_name.end())
+        return exact->second;
+    for (module_id id = 0; id < m_module_names.size(); id++) {
+        if (equal_ignoring_case(m_module_names[id], name))
+            return id;
+    }
+    return nullopt;
+}
+
+std::size_t trace_store::frame_count() const noexcept
+{
+    return m_frames.size();
+}
+
+std::size_t trace_store::trace_count() const noexcept
+{
+    return m_traces.size();
+}
+
+std::size_t trace_store::module_count() const noexcept
+{
+    return m_module_names.size();
+}
+
+std::size_t trace_store::memory_usage() const noexcept
+{
+    return m_frame_text.capacity() +
+        m_frame_modules.capacity() * sizeof(module_id) +
+        m_trace_modules.capacity() * sizeof(module_id) +
+        m_frame_offsets.capacity() * sizeof(std::size_t) +
+        m_trace_frames.capacity() * sizeof(frame_id) +
+        m_frame_tokens.capacity() * sizeof(frame_rules::token) +
+        m_trace_offsets.capacity() * sizeof(std::size_t) +
+        m_frames.memory_usage() +
+        m_traces.memory_usage() +
+        m_original_frames.capacity() * sizeof(frame_id) +
+        m_originals.capacity() * sizeof(original_trace) +
+        m_original_traces.memory_usage();
+}
+
+frame_rules const& trace_store::rules() const noexcept
+{
+    return m_rules;
+}
+
+trace_store::trace_store(frame_rules rules)
+    : m_rules(std::move(rules))
+{
+}
+
+module_id trace_store::intern_module(string_view const frame)
+{
+    auto const name = module_name(frame);
+    if (auto const existing = m_module_by_name.find(name); existing != m_module_by_name.end())
+        return existing->second;
+
+    auto const id = static_cast<module_id>(m_module_names.size());
+    m_module_names.emplace_back(name);
+    m_attributable_modules.push_back(!name.empty() && !frame_rules::is_allocator_module(name));
+    m_module_by_name.emplace(string(name), id);
+    return id;
+}
+
+span<frame_id const> trace_store::original_frames(std::uint32_t const id) const noexcept
+{
+    auto const& entry = m_originals[id];
+    return entry.begin == entry.end
+        ? trace(entry.rewritten)
+        : span<frame_id const>(m_original_frames.data() + entry.begin, entry.end - entry.begin);
+}
+
+module_id trace_store::attribute(span<frame_id const> const frames) const noexcept
+{
+    for (auto const frame : frames) {
+        if (m_attributable_modules[m_frame_modules[frame]])
+            return m_frame_modules[frame];
+    }
+    return frames.empty() ? 0U : m_frame_modules[frames.back()];
+}
+
+}
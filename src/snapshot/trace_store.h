@@ -0,0 +1,125 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/trace_id.h"
+#include "frame_rules.h"
+#include "intern_table.h"
+
+namespace snapshot::model
+{
+    /// <summary>assigns 32 bit ids to distinct frames and backtraces so snapshots can refer to them by id alone</summary>
+    /// <remarks>
+    /// frame text is kept in a single contiguous arena and backtraces as runs of frame ids in another, so a
+    /// frame repeated across millions of backtraces costs four bytes per use rather than a string; ids are
+    /// dense, starting at zero in order of first appearance, which lets callers index vectors by them.
+    /// each backtrace is also attributed to a module as it is first interned, so grouping by module
+    /// never has to revisit frame text. backtraces are rewritten by the store's frame_rules before they are
+    /// interned, frames being classified against the rules once each as they are first seen and each
+    /// distinct backtrace being rewritten once, repeats mapping straight to the id it was rewritten to.
+    /// not thread safe, interning from several threads needs external locking
+    /// </remarks>
+    class trace_store final
+    {
+    public:
+        [[nodiscard]] SNAPSHOT_DLL frame_id intern_frame(std::string_view const frame);
+        /// <summary>interns frames as rewritten by rules, so backtraces differing only in stripped frames share an id</summary>
+        [[nodiscard]] SNAPSHOT_DLL trace_id intern_trace(std::span<frame_id const> const frames);
+        /// <summary>interns each frame then the backtrace they form</summary>
+        [[nodiscard]] SNAPSHOT_DLL trace_id intern_trace(std::span<std::string_view const> const frames);
+
+        /// <summary>text of id, valid until the next frame is interned</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::string_view frame(frame_id const id) const noexcept;
+        /// <summary>frames of id innermost first, valid until the next backtrace is interned</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::span<frame_id const> trace(trace_id const id) const noexcept;
+
+        /// <summary>module of the frame, the text before '!', or the unnamed module for unsymbolized frames</summary>
+        [[nodiscard]] SNAPSHOT_DLL module_id frame_module(frame_id const id) const noexcept;
+        /// <summary>module id is attributed to, that of its innermost symbolized frame outside the heap and CRT modules</summary>
+        /// <remarks>backtraces with no such frame are attributed to the module of their outermost frame</remarks>
+        [[nodiscard]] SNAPSHOT_DLL module_id module_of(trace_id const id) const noexcept;
+        /// <summary>name of id, valid until the next module is interned</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::string_view module(module_id const id) const noexcept;
+        /// <summary>finds a module by name ignoring ASCII case, as module names are on Windows</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::optional<module_id> find_module(std::string_view const name) const noexcept;
+
+        [[nodiscard]] SNAPSHOT_DLL std::size_t frame_count() const noexcept;
+        [[nodiscard]] SNAPSHOT_DLL std::size_t trace_count() const noexcept;
+        /// <summary>number of distinct modules, including the unnamed module which always has id zero</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::size_t module_count() const noexcept;
+        /// <summary>bytes reserved by the arenas and lookup tables</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::size_t memory_usage() const noexcept;
+        [[nodiscard]] SNAPSHOT_DLL frame_rules const& rules() const noexcept;
+
+        SNAPSHOT_DLL trace_store() = default;
+        SNAPSHOT_DLL explicit trace_store(frame_rules rules);
+        trace_store(trace_store const&) = delete;
+        trace_store& operator=(trace_store const&) = delete;
+        SNAPSHOT_DLL trace_store(trace_store&&) noexcept = default;
+        SNAPSHOT_DLL trace_store& operator=(trace_store&&) noexcept = default;
+        SNAPSHOT_DLL ~trace_store() = default;
+
+    private:
+        /// <summary>backtrace as given to intern_trace and the id it was rewritten to</summary>
+        struct original_trace
+        {
+            trace_id rewritten{};
+            /// <summary>range of its frames in m_original_frames, empty when the rules left it unchanged so its frames are those of rewritten</summary>
+            std::size_t begin{};
+            std::size_t end{};
+        };
+
+        struct module_hash
+        {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view const value) const noexcept
+            {
+                return std::hash<std::string_view>()(value);
+            }
+        };
+
+        std::vector<char> m_frame_text{};
+        std::vector<std::size_t> m_frame_offsets{0};
+        infrastructure::intern_table m_frames{};
+        std::vector<frame_id> m_trace_frames{};
+        std::vector<std::size_t> m_trace_offsets{0};
+        infrastructure::intern_table m_traces{};
+        std::vector<frame_id> m_interned{};
+        frame_rules m_rules{};
+        std::vector<frame_rules::token> m_frame_tokens{};
+        std::vector<frame_id> m_rewritten{};
+        std::vector<frame_id> m_original_frames{};
+        std::vector<original_trace> m_originals{};
+        infrastructure::intern_table m_original_traces{};
+        std::vector<module_id> m_frame_modules{};
+        std::vector<module_id> m_trace_modules{};
+        std::vector<std::string> m_module_names{""};
+        std::vector<bool> m_attributable_modules{false};
+        std::unordered_map<std::string, module_id, module_hash, std::equal_to<>> m_module_by_name{{"", 0U}};
+
+        [[nodiscard]] trace_id intern_rewritten(std::span<frame_id const> const frames);
+        [[nodiscard]] std::span<frame_id const> original_frames(std::uint32_t const id) const noexcept;
+        [[nodiscard]] module_id intern_module(std::string_view const frame);
+        [[nodiscard]] module_id attribute(std::span<frame_id const> const frames) const noexcept;
+    };
+
+}
@@ -0,0 +1,117 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "trend_analyzer.h"
+#include <stdexcept>
+
+using std::nullopt;
+using std::optional;
+using std::vector;
+
+namespace snapshot::model
+{
+
+void trend_analyzer::add(heap_snapshot const& snapshot, time_point const taken)
+{
+    if (m_traces != nullptr && snapshot.traces != nullptr && snapshot.traces != m_traces)
+        throw std::invalid_argument("snapshot does not share the trace_store of earlier snapshots");
+    if (!m_origin.has_value())
+        m_origin = taken;
+
+    // measuring from the first snapshot keeps the sums small enough that double precision holds up
+    auto const x = std::chrono::duration<double>(taken - m_origin.value()).count();
+    if (m_snapshots != 0 && x < m_last_x)
+        throw std::invalid_argument("snapshot precedes the latest snapshot added");
+
+    if (m_traces == nullptr)
+        m_traces = snapshot.traces;
+    m_last_x = x;
+    m_sum_x += x;
+    m_sum_xx += x * x;
+    m_snapshots++;
+
+    if (snapshot.size() != 0 && snapshot.trace_ids.back() >= m_statistics.size())
+        m_statistics.resize(static_cast<std::size_t>(snapshot.trace_ids.back()) + 1);
+    for (std::size_t row = 0; row < snapshot.size(); row++) {
+        auto& statistics = m_statistics[snapshot.trace_ids[row]];
+        auto const y = static_cast<double>(snapshot.bytes[row]);
+        statistics.sum_y += y;
+        statistics.sum_xy += x * y;
+        statistics.last_bytes = snapshot.bytes[row];
+        statistics.samples++;
+        statistics.last_snapshot = m_snapshots;
+    }
+}
+
+vector<leak_trend> trend_analyzer::top(std::size_t const count, std::size_t const minimum_samples) const
+{
+    // a min heap of the best count seen so far, so ranking costs log(count) per backtrace rather than a full sort
+    auto const steeper = [](leak_trend const& left, leak_trend const& right) {
+        return left.bytes_per_second > right.bytes_per_second ||
+            (left.bytes_per_second == right.bytes_per_second && left.trace < right.trace);
+    };
+
+    vector<leak_trend> best{};
+    if (count == 0)
+        return best;
+    best.reserve(count + 1);
+    for (trace_id trace = 0; trace < m_statistics.size(); trace++) {
+        if (m_statistics[trace].samples == 0 || m_statistics[trace].samples < minimum_samples)
+            continue;
+        auto const trend = trend_of(trace);
+        if (trend.bytes_per_second <= 0.0)
+            continue;
+        if (best.size() == count && !steeper(trend, best.front()))
+            continue;
+
+        best.push_back(trend);
+        std::push_heap(best.begin(), best.end(), steeper);
+        if (best.size() > count) {
+            std::pop_heap(best.begin(), best.end(), steeper);
+            best.pop_back();
+        }
+    }
+    std::sort_heap(best.begin(), best.end(), steeper);
+    return best;
+}
+
+optional<leak_trend> trend_analyzer::find(trace_id const trace) const noexcept
+{
+    return trace < m_statistics.size() && m_statistics[trace].samples != 0
+        ? optional(trend_of(trace))
+        : nullopt;
+}
+
+std::size_t trend_analyzer::snapshot_count() const noexcept
+{
+    return m_snapshots;
+}
+
+leak_trend trend_analyzer::trend_of(trace_id const trace) const noexcept
+{
+    auto const& statistics = m_statistics[trace];
+    auto const n = static_cast<double>(m_snapshots);
+    auto const denominator = n * m_sum_xx - m_sum_x * m_sum_x;
+
+    leak_trend trend{};
+    trend.trace = trace;
+    trend.bytes_per_second = denominator > 0.0
+        ? (n * statistics.sum_xy - m_sum_x * statistics.sum_y) / denominator
+        : 0.0;
+    trend.bytes = statistics.last_snapshot == m_snapshots ? statistics.last_bytes : 0ULL;
+    trend.samples = statistics.samples;
+    return trend;
+}
+
+}
@@ -0,0 +1,83 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/trace_id.h"
+#include "heap_snapshot.h"
+#include "trace_store.h"
+
+namespace snapshot::model
+{
+    /// <summary>fitted growth of one backtrace across the snapshots seen so far</summary>
+    struct leak_trend
+    {
+        trace_id trace{};
+        /// <summary>least squares slope of bytes over time, in bytes per second</summary>
+        double bytes_per_second{};
+        /// <summary>bytes in the latest snapshot, zero if the backtrace was absent from it</summary>
+        std::uint64_t bytes{};
+        /// <summary>number of snapshots the backtrace appeared in</summary>
+        std::size_t samples{};
+    };
+
+    /// <summary>ranks backtraces by the slope of their growth over a series of snapshots</summary>
+    /// <remarks>
+    /// keeps running least squares sums rather than history; the sums over time are shared by every
+    /// backtrace and a backtrace absent from a snapshot contributes zero to its own sums, so adding a
+    /// snapshot only touches the rows it contains
+    /// </remarks>
+    class trend_analyzer final
+    {
+    public:
+        using time_point = std::chrono::system_clock::time_point;
+
+        /// <summary>adds snapshot as taken at taken, which must not precede any snapshot already added</summary>
+        /// <exception cref="std::invalid_argument">
+        /// when snapshot is out of order or was interned into a different trace_store to earlier snapshots
+        /// </exception>
+        SNAPSHOT_DLL void add(heap_snapshot const& snapshot, time_point const taken);
+        /// <summary>returns up to count backtraces with the steepest positive growth, steepest first</summary>
+        /// <param name="minimum_samples">backtraces seen in fewer snapshots than this are not ranked</param>
+        [[nodiscard]] SNAPSHOT_DLL std::vector<leak_trend> top(std::size_t const count, std::size_t const minimum_samples = 2) const;
+        [[nodiscard]] SNAPSHOT_DLL std::optional<leak_trend> find(trace_id const trace) const noexcept;
+        [[nodiscard]] SNAPSHOT_DLL std::size_t snapshot_count() const noexcept;
+
+    private:
+        struct statistics
+        {
+            double sum_y{};
+            double sum_xy{};
+            std::uint64_t last_bytes{};
+            std::uint32_t samples{};
+            std::uint32_t last_snapshot{};
+        };
+
+        std::shared_ptr<trace_store const> m_traces{};
+        std::vector<statistics> m_statistics{};
+        std::optional<time_point> m_origin{};
+        double m_last_x{};
+        double m_sum_x{};
+        double m_sum_xx{};
+        std::uint32_t m_snapshots{};
+
+        [[nodiscard]] leak_trend trend_of(trace_id const trace) const noexcept;
+    };
+
+}
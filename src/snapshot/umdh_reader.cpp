@@ -0,0 +1,257 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "umdh_reader.h"
+
+using std::string_view;
+
+using snapshot::model::umdh_format;
+using snapshot::model::umdh_radix;
+using snapshot::model::umdh_record;
+
+namespace
+{
+    constexpr string_view WHITESPACE = " \t\r";
+    constexpr string_view BACKTRACE = "BackTrace";
+
+    [[nodiscard]] bool is_blank(char const value) noexcept
+    {
+        return value == ' ' || value == '\t' || value == '\r';
+    }
+
+    [[nodiscard]] string_view trim(string_view text) noexcept
+    {
+        auto const first = text.find_first_not_of(WHITESPACE);
+        if (first == string_view::npos)
+            return string_view{};
+        auto const last = text.find_last_not_of(WHITESPACE);
+        return text.substr(first, last - first + 1);
+    }
+
+    void skip_blanks(string_view& text) noexcept
+    {
+        while (!text.empty() && is_blank(text.front()))
+            text.remove_prefix(1);
+    }
+
+    [[nodiscard]] bool consume(string_view& text, string_view const token) noexcept
+    {
+        skip_blanks(text);
+        if (!text.starts_with(token))
+            return false;
+        text.remove_prefix(token.size());
+        return true;
+    }
+
+    [[nodiscard]] bool consume_number(string_view& text, int const base, std::uint64_t& value) noexcept
+    {
+        skip_blanks(text);
+        if (base == 16 && (text.starts_with("0x") || text.starts_with("0X")))
+            text.remove_prefix(2);
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+        if (error != std::errc{})
+            return false;
+        text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+        return true;
+    }
+
+    [[nodiscard]] bool consume_backtrace(string_view& text, std::uint64_t& backtrace_id) noexcept
+    {
+        return consume(text, BACKTRACE) && consume_number(text, 16, backtrace_id);
+    }
+
+    /// <summary>
+    /// "40 bytes + 18 at 35A838 by BackTrace53" from older umdh, one allocation per line, or
+    /// "A0 bytes in 0x2 allocations (@ 0x50 + 0x10) by: BackTrace53" from current versions
+    /// </summary>
+    [[nodiscard]] bool parse_log_header(string_view line, umdh_record& record) noexcept
+    {
+        std::uint64_t ignored{};
+        if (!consume_number(line, 16, record.bytes) || !consume(line, "bytes"))
+            return false;
+
+        if (consume(line, "+")) {
+            record.count = 1;
+            return consume_number(line, 16, ignored) && consume(line, "at") && consume_number(line, 16, ignored) &&
+                consume(line, "by") && consume_backtrace(line, record.backtrace_id);
+        }
+
+        return consume(line, "in") && consume_number(line, 16, record.count) && consume(line, "allocations") &&
+            consume(line, "(@") && consume_number(line, 16, ignored) && consume(line, "+") && consume_number(line, 16, ignored) &&
+            consume(line, ")") && consume(line, "by:") && consume_backtrace(line, record.backtrace_id);
+    }
+
+    [[nodiscard]] int base_of(umdh_radix const radix) noexcept
+    {
+        return radix == umdh_radix::DECIMAL ? 10 : 16;
+    }
+
+    /// <summary>"+ 5320 ( f110 - 9df0) 3a allocs BackTrace1" leaving the counts line to parse_diff_counts</summary>
+    [[nodiscard]] bool parse_diff_values(string_view& line, int const base, std::uint64_t& current, std::uint64_t& previous) noexcept
+    {
+        std::uint64_t ignored{};
+        if (!consume(line, "+") && !consume(line, "-"))
+            return false;
+        return consume_number(line, base, ignored) && consume(line, "(") && consume_number(line, base, current) &&
+            consume(line, "-") && consume_number(line, base, previous) && consume(line, ")");
+    }
+
+    [[nodiscard]] bool parse_diff_header(string_view line, int const base, umdh_record& record) noexcept
+    {
+        return parse_diff_values(line, base, record.bytes, record.previous_bytes) &&
+            consume_number(line, base, record.count) && consume(line, "allocs") &&
+            consume_backtrace(line, record.backtrace_id);
+    }
+
+    /// <summary>"+ 1a ( 3a - 20) BackTrace1 allocations", following the header of the same backtrace</summary>
+    [[nodiscard]] bool parse_diff_counts(string_view line, int const base, umdh_record& record) noexcept
+    {
+        std::uint64_t current{};
+        std::uint64_t previous{};
+        std::uint64_t backtraceId{};
+        if (!parse_diff_values(line, base, current, previous) || !consume_backtrace(line, backtraceId) || backtraceId != record.backtrace_id)
+            return false;
+        record.count = current;
+        record.previous_count = previous;
+        return true;
+    }
+}
+
+namespace snapshot::infrastructure
+{
+
+bool umdh_reader::read_next(umdh_record& record)
+{
+    string_view line{};
+    std::size_t next{};
+    while (peek_line(line, next)) {
+        m_position = next;
+        if (line.empty() || is_blank(line.front()))
+            continue;
+
+        record.frames.clear();
+        record.previous_bytes = 0;
+        record.previous_count = 0;
+
+        if (m_format != umdh_format::DIFF && parse_log_header(line, record)) {
+            m_format = umdh_format::LOG;
+        } else if (m_format != umdh_format::LOG && parse_diff_header(line, base_of(m_diff_radix), record)) {
+            m_format = umdh_format::DIFF;
+            if (peek_line(line, next) && parse_diff_counts(line, base_of(m_diff_radix), record))
+                m_position = next;
+        } else {
+            continue;
+        }
+
+        read_frames(record);
+        return true;
+    }
+    return false;
+}
+
+umdh_format umdh_reader::format() const noexcept
+{
+    return m_format;
+}
+
+std::size_t umdh_reader::position() const noexcept
+{
+    return m_position;
+}
+
+std::size_t umdh_reader::find_record(string_view const text, std::size_t const offset) noexcept
+{
+    auto position = offset;
+    if (position != 0 && position < text.size() && text[position - 1] != '\n') {
+        position = text.find('\n', position);
+        position = position == string_view::npos ? text.size() : position + 1;
+    }
+
+    // a decimal number reads as hexadecimal up to the same character, so headers are found whatever the radix
+    umdh_record record{};
+    while (position < text.size()) {
+        auto const end = text.find('\n', position);
+        auto const line = text.substr(position, (end == string_view::npos ? text.size() : end) - position);
+        if (!line.empty() && !is_blank(line.front()) && (parse_log_header(line, record) || parse_diff_header(line, 16, record)))
+            return position;
+        position = end == string_view::npos ? text.size() : end + 1;
+    }
+    return text.size();
+}
+
+umdh_reader::umdh_reader(string_view const text, umdh_radix const diff_radix) noexcept
+    : m_text(text)
+    , m_diff_radix(diff_radix)
+{
+}
+
+bool umdh_reader::peek_line(string_view& line, std::size_t& next) const noexcept
+{
+    if (m_position >= m_text.size())
+        return false;
+
+    auto const end = m_text.find('\n', m_position);
+    next = end == string_view::npos ? m_text.size() : end + 1;
+    line = m_text.substr(m_position, (end == string_view::npos ? m_text.size() : end) - m_position);
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return true;
+}
+
+void umdh_reader::read_frames(umdh_record& record)
+{
+    // frames are indented, diffs leave a blank line between the header and the first of them and both
+    // formats end the backtrace with one; an unindented line is the next record so is left unread
+    string_view line{};
+    std::size_t next{};
+    while (peek_line(line, next)) {
+        auto const frame = trim(line);
+        if (frame.empty()) {
+            m_position = next;
+            if (!record.frames.empty())
+                return;
+            continue;
+        }
+        if (!is_blank(line.front()))
+            return;
+
+        record.frames.push_back(frame);
+        m_position = next;
+    }
+}
+
+bool umdh_file_reader::read_next(umdh_record& record)
+{
+    // the previous record's frames are no longer in use so everything before it can go, in steps of
+    // DISCARD_INTERVAL so the cost is one call per interval rather than one per record
+    if (m_record_start - m_last_discard >= DISCARD_INTERVAL) {
+        m_file.discard(m_record_start);
+        m_last_discard = m_record_start;
+    }
+    m_record_start = m_reader.position();
+    return m_reader.read_next(record);
+}
+
+umdh_format umdh_file_reader::format() const noexcept
+{
+    return m_reader.format();
+}
+
+umdh_file_reader::umdh_file_reader(std::filesystem::path const& filename, umdh_radix const diff_radix)
+    : m_file(filename)
+    , m_reader(m_file.view(), diff_radix)
+{
+}
+
+}
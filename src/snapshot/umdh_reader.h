@@ -0,0 +1,77 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include "snapshot/snapshot_export.h"
+#include "snapshot/umdh_record.h"
+#include "mapped_file.h"
+
+namespace snapshot::infrastructure
+{
+    /// <summary>tokenizes umdh log or diff text into records in a single forward pass</summary>
+    /// <remarks>
+    /// lines are never copied, record frames view text directly; lines which aren't part of a record such
+    /// as the comment header, heap separators and totals are skipped, as is anything unrecognised
+    /// </remarks>
+    class umdh_reader final
+    {
+    public:
+        /// <summary>reads the next record, reusing the storage of record so a pass allocates only for the longest backtrace</summary>
+        [[nodiscard]] SNAPSHOT_DLL bool read_next(model::umdh_record& record);
+        /// <summary>format of the records read so far, detected from the first of them</summary>
+        [[nodiscard]] SNAPSHOT_DLL model::umdh_format format() const noexcept;
+        /// <summary>offset into text of the first character not yet read</summary>
+        [[nodiscard]] SNAPSHOT_DLL std::size_t position() const noexcept;
+
+        /// <summary>offset of the first record header in text starting on a line at or after offset, or the size of text if there is none</summary>
+        /// <remarks>used to split text into pieces which can be read independently</remarks>
+        [[nodiscard]] SNAPSHOT_DLL static std::size_t find_record(std::string_view const text, std::size_t const offset) noexcept;
+
+        /// <param name="diff_radix">base of the sizes and counts if text is a diff, logs are always hexadecimal</param>
+        SNAPSHOT_DLL explicit umdh_reader(std::string_view const text, model::umdh_radix const diff_radix = model::umdh_radix::HEXADECIMAL) noexcept;
+
+    private:
+        std::string_view m_text;
+        model::umdh_radix m_diff_radix;
+        std::size_t m_position{};
+        model::umdh_format m_format{model::umdh_format::UNKNOWN};
+
+        [[nodiscard]] bool peek_line(std::string_view& line, std::size_t& next) const noexcept;
+        void read_frames(model::umdh_record& record);
+    };
+
+    /// <summary>umdh_reader over a mapped file which releases the pages it has finished with</summary>
+    class umdh_file_reader final
+    {
+    public:
+        /// <summary>as umdh_reader::read_next, frames are valid until the next call</summary>
+        [[nodiscard]] SNAPSHOT_DLL bool read_next(model::umdh_record& record);
+        [[nodiscard]] SNAPSHOT_DLL model::umdh_format format() const noexcept;
+
+        /// <exception cref="std::system_error">when the file cannot be opened or mapped</exception>
+        SNAPSHOT_DLL explicit umdh_file_reader(std::filesystem::path const& filename, model::umdh_radix const diff_radix = model::umdh_radix::HEXADECIMAL);
+
+    private:
+        static constexpr std::size_t DISCARD_INTERVAL = 64ULL * 1024ULL * 1024ULL;
+
+        mapped_file m_file;
+        umdh_reader m_reader;
+        std::size_t m_record_start{};
+        std::size_t m_last_discard{};
+    };
+
+}
@@ -0,0 +1,57 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace snapshot::infrastructure
+{
+    /// <summary>appends value as a little endian base 128 varint, seven bits per byte with the high bit marking continuation</summary>
+    inline void write_varint(std::string& output, std::uint64_t value)
+    {
+        while (value >= 0x80ULL) {
+            output.push_back(static_cast<char>((value & 0x7FULL) | 0x80ULL));
+            value >>= 7;
+        }
+        output.push_back(static_cast<char>(value));
+    }
+
+    /// <summary>reads a varint from the front of input, returning false if input ends first or the value overflows</summary>
+    [[nodiscard]] inline bool read_varint(std::string_view& input, std::uint64_t& value) noexcept
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && !input.empty(); shift += 7) {
+            auto const byte = static_cast<std::uint8_t>(input.front());
+            input.remove_prefix(1);
+            value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    /// <summary>maps signed values to unsigned so small magnitudes of either sign encode to few bytes</summary>
+    [[nodiscard]] constexpr std::uint64_t zigzag_encode(std::int64_t const value) noexcept
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    [[nodiscard]] constexpr std::int64_t zigzag_decode(std::uint64_t const value) noexcept
+    {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1ULL);
+    }
+
+}
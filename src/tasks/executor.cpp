@@ -0,0 +1,190 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/executor.h>
+#include "work_stealing_deque.h"
+
+namespace tasks
+{
+    struct executor_worker
+    {
+        executor* owner{};
+        work_stealing_deque<task*> queue{};
+        /// <summary>xorshift state choosing where to start looking for work to steal</summary>
+        std::uint32_t random{};
+    };
+}
+
+namespace
+{
+    thread_local tasks::executor_worker* current_worker{nullptr};
+
+    [[nodiscard]] std::uint32_t next_random(std::uint32_t& state) noexcept
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+namespace tasks
+{
+
+void executor::submit(task& work)
+{
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (current_worker != nullptr && current_worker->owner == this) {
+        current_worker->queue.push(&work);
+    } else {
+        std::lock_guard const lock(m_shared_lock);
+        m_shared.push_back(&work);
+        m_shared_empty.store(false, std::memory_order_relaxed);
+    }
+    wake();
+}
+
+void executor::wait_idle()
+{
+    for (auto pending = m_pending.load(std::memory_order_acquire); pending != 0; pending = m_pending.load(std::memory_order_acquire))
+        m_pending.wait(pending, std::memory_order_acquire);
+
+    std::exception_ptr error{};
+    {
+        std::lock_guard const lock(m_error_lock);
+        std::swap(error, m_error);
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+std::size_t executor::worker_count() const noexcept
+{
+    return m_workers.size();
+}
+
+executor::executor(std::size_t workers)
+{
+    if (workers == 0)
+        workers = std::max(1U, std::thread::hardware_concurrency());
+
+    m_workers.reserve(workers);
+    for (std::size_t index = 0; index < workers; index++) {
+        auto worker = std::make_unique<executor_worker>();
+        worker->owner = this;
+        worker->random = static_cast<std::uint32_t>(index * 2654435761U) | 1U;
+        m_workers.push_back(std::move(worker));
+    }
+    m_threads.reserve(workers);
+    for (std::size_t index = 0; index < workers; index++)
+        m_threads.emplace_back([this, index]() { run(index); });
+}
+
+executor::~executor()
+{
+    m_stopping.store(true, std::memory_order_seq_cst);
+    m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    m_epoch.notify_all();
+    m_threads.clear();
+}
+
+void executor::run(std::size_t const index)
+{
+    auto& worker = *m_workers[index];
+    current_worker = &worker;
+
+    while (true) {
+        if (auto* const work = find_work(worker); work != nullptr) {
+            process(*work);
+            continue;
+        }
+
+        // a submission after epoch is read changes it, so the wait below cannot miss that work
+        auto const epoch = m_epoch.load(std::memory_order_seq_cst);
+        if (auto* const work = find_work(worker); work != nullptr) {
+            process(*work);
+            continue;
+        }
+        if (m_stopping.load(std::memory_order_seq_cst))
+            break;
+
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        m_epoch.wait(epoch, std::memory_order_seq_cst);
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+    current_worker = nullptr;
+}
+
+task* executor::find_work(executor_worker& worker)
+{
+    if (auto const own = worker.queue.pop(); own.has_value())
+        return own.value();
+    if (auto* const shared = take_shared(); shared != nullptr)
+        return shared;
+
+    auto const count = m_workers.size();
+    auto const start = next_random(worker.random) % count;
+    for (std::size_t offset = 0; offset < count; offset++) {
+        auto& victim = *m_workers[(start + offset) % count];
+        if (&victim == &worker)
+            continue;
+        if (auto const stolen = victim.queue.steal(); stolen.has_value())
+            return stolen.value();
+    }
+    return nullptr;
+}
+
+task* executor::take_shared()
+{
+    if (m_shared_empty.load(std::memory_order_relaxed))
+        return nullptr;
+
+    std::lock_guard const lock(m_shared_lock);
+    if (m_shared.empty())
+        return nullptr;
+    auto* const work = m_shared.front();
+    m_shared.pop_front();
+    m_shared_empty.store(m_shared.empty(), std::memory_order_relaxed);
+    return work;
+}
+
+void executor::process(task& work)
+{
+    // tasks submitted without being marked ready are run without tracking, tasks which set their own
+    // final state from process keep it since the transitions out of RUNNING below then fail
+    auto const tracked = work.transition(task_state::READY, task_state::RUNNING);
+    try {
+        work.process();
+        if (tracked)
+            static_cast<void>(work.transition(task_state::RUNNING, task_state::COMPLETE));
+    } catch (...) {
+        if (tracked)
+            static_cast<void>(work.transition(task_state::RUNNING, task_state::FAILED));
+        std::lock_guard const lock(m_error_lock);
+        if (!m_error)
+            m_error = std::current_exception();
+    }
+
+    if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        m_pending.notify_all();
+}
+
+void executor::wake() noexcept
+{
+    m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_seq_cst) != 0)
+        m_epoch.notify_one();
+}
+
+}
@@ -13,27 +13,166 @@
 
 #include "pch.h"
 #include <tasks/task.h>
+#include <algorithm>
+
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+namespace
+{
+    /// <summary>weight of the newest run in the average run time, as a right shift</summary>
+    constexpr int AVERAGE_SHIFT = 3;
+}
 
 namespace tasks
 {
 
+task::task(task const& other) noexcept
+    : m_current_state(other.m_current_state.load(std::memory_order_acquire))
+    , m_expected_completion(other.m_expected_completion.load(std::memory_order_relaxed))
+    , m_started(other.m_started.load(std::memory_order_relaxed))
+    , m_finished(other.m_finished.load(std::memory_order_relaxed))
+    , m_average_duration(other.m_average_duration.load(std::memory_order_relaxed))
+    , m_next_estimate(other.m_next_estimate.load(std::memory_order_relaxed))
+{
+}
+task::task(task&& other) noexcept
+    : task(static_cast<task const&>(other))
+{
+}
+
+task& task::operator=(task const& other) noexcept
+{
+    if (this == &other)
+        return *this;
+    m_expected_completion.store(other.m_expected_completion.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_started.store(other.m_started.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_finished.store(other.m_finished.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_average_duration.store(other.m_average_duration.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_next_estimate.store(other.m_next_estimate.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_current_state.store(other.m_current_state.load(std::memory_order_acquire), std::memory_order_release);
+    return *this;
+}
+task& task::operator=(task&& other) noexcept
+{
+    return *this = static_cast<task const&>(other);
+}
+
 task_state task::get_current_state() const noexcept
 {
-    return m_current_state;
+    return m_current_state.load(std::memory_order_acquire);
 }
-std::chrono::milliseconds task::get_estimated_time_remaining() const noexcept
+milliseconds task::get_estimated_time_remaining() const noexcept
 {
-    return m_time_remaining;
+    switch (get_current_state()) {
+    case task_state::PENDING:
+    case task_state::READY: {
+        auto const estimate = m_next_estimate.load(std::memory_order_relaxed);
+        return duration_cast<milliseconds>(clock::duration(estimate != 0 ? estimate : m_average_duration.load(std::memory_order_relaxed)));
+    }
+    case task_state::RUNNING: {
+        auto const remaining = clock::duration(m_expected_completion.load(std::memory_order_relaxed)) - clock::now().time_since_epoch();
+        return remaining > clock::duration::zero()
+            ? duration_cast<milliseconds>(remaining)
+            : milliseconds::zero();
+    }
+    default:
+        return milliseconds::zero();
+    }
 }
 
-inline void task::update_task_state(task_state const value)
+bool task::mark_ready() noexcept
 {
-    m_current_state = value;
+    auto current = m_current_state.load(std::memory_order_acquire);
+    while (is_valid_transition(current, task_state::READY)) {
+        if (m_current_state.compare_exchange_weak(current, task_state::READY, std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+    }
+    return false;
 }
 
-inline void task::update_time_remaining(task_state const value)
+bool task::transition(task_state const expected, task_state const desired) noexcept
 {
-    m_current_state = value;
+    if (!is_valid_transition(expected, desired))
+        return false;
+    if (expected == task_state::RUNNING)
+        return finish_run(desired);
+
+    auto current = expected;
+    if (!m_current_state.compare_exchange_strong(current, desired, std::memory_order_acq_rel, std::memory_order_acquire))
+        return false;
+    if (desired == task_state::RUNNING)
+        start_run();
+    return true;
+}
+
+bool task::is_valid_transition(task_state const from, task_state const to) noexcept
+{
+    switch (to) {
+    case task_state::READY:
+        return from == task_state::PENDING || from == task_state::COMPLETE || from == task_state::FAILED;
+    case task_state::RUNNING:
+        return from == task_state::READY;
+    case task_state::COMPLETE:
+    case task_state::FAILED:
+        return from == task_state::RUNNING;
+    default:
+        return false;
+    }
+}
+
+bool task::update_task_state(task_state const value) noexcept
+{
+    auto current = m_current_state.load(std::memory_order_acquire);
+    while (is_valid_transition(current, value)) {
+        if (transition(current, value))
+            return true;
+        current = m_current_state.load(std::memory_order_acquire);
+    }
+    return false;
+}
+
+void task::update_time_remaining(milliseconds const value) noexcept
+{
+    // outside a run there is no completion to move, the report is kept as the estimate for the next run
+    if (get_current_state() != task_state::RUNNING) {
+        m_next_estimate.store(duration_cast<clock::duration>(value).count(), std::memory_order_relaxed);
+        return;
+    }
+    auto const completion = clock::now().time_since_epoch() + value;
+    m_expected_completion.store(duration_cast<clock::duration>(completion).count(), std::memory_order_relaxed);
+}
+
+void task::start_run() noexcept
+{
+    // only the thread which won READY to RUNNING gets here and the run cannot be finished until m_started is
+    // published. a run starts strictly after the previous one finished, so a finisher holding a stale start
+    // time can never claim a later run
+    auto const now = std::max(clock::now().time_since_epoch().count(), m_finished.load(std::memory_order_relaxed) + 1);
+    auto const estimate = m_next_estimate.exchange(0, std::memory_order_relaxed);
+    m_expected_completion.store(now + (estimate != 0 ? estimate : m_average_duration.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+    m_started.store(now, std::memory_order_release);
+}
+
+bool task::finish_run(task_state const desired) noexcept
+{
+    // the run is accounted for while the task is still RUNNING, once the state leaves RUNNING the task can
+    // be made ready and started again by another thread. of several threads racing to finish the run only
+    // the one which swaps out its start time updates the fields and publishes the new state
+    auto started = m_started.load(std::memory_order_acquire);
+    if (started == FINISHED_RUN || get_current_state() != task_state::RUNNING)
+        return false;
+    if (!m_started.compare_exchange_strong(started, FINISHED_RUN, std::memory_order_acq_rel, std::memory_order_relaxed))
+        return false;
+
+    auto const now = std::max(clock::now().time_since_epoch().count(), started);
+    auto const duration = now - started;
+    auto const average = m_average_duration.load(std::memory_order_relaxed);
+    m_average_duration.store(average == 0 ? duration : average + ((duration - average) >> AVERAGE_SHIFT), std::memory_order_relaxed);
+    m_expected_completion.store(now, std::memory_order_relaxed);
+    m_finished.store(now, std::memory_order_relaxed);
+    m_current_state.store(desired, std::memory_order_release);
+    return true;
 }
 
 }
@@ -0,0 +1,241 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timer_wheel.h>
+#include <stdexcept>
+
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace
+{
+    [[nodiscard]] uint64_t next_random(uint64_t& state) noexcept
+    {
+        // splitmix64
+        auto value = (state += 0x9E3779B97F4A7C15ULL);
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+}
+
+namespace tasks
+{
+
+timer_handle timer_wheel::schedule(task& work, clock::time_point const due, clock::duration const period, clock::duration const jitter)
+{
+    if (period < clock::duration::zero())
+        throw std::invalid_argument("period cannot be negative");
+    if (jitter < clock::duration::zero())
+        throw std::invalid_argument("jitter cannot be negative");
+
+    uint32_t index{};
+    if (m_free != NONE) {
+        index = m_free;
+        m_free = m_timers[index].next;
+    } else {
+        index = static_cast<uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+
+    auto& entry = m_timers[index];
+    entry.work = &work;
+    entry.scheduled = std::max(due - m_start, clock::duration::zero());
+    entry.period = period;
+    entry.jitter = jitter;
+    entry.due = due_tick(entry);
+    insert(index);
+    m_size++;
+    return {index, entry.generation};
+}
+
+bool timer_wheel::cancel(timer_handle const handle) noexcept
+{
+    if (handle.index >= m_timers.size())
+        return false;
+    auto const& entry = m_timers[handle.index];
+    if (entry.generation != handle.generation || entry.bucket == NONE)
+        return false;
+
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+}
+
+size_t timer_wheel::advance(clock::time_point const now, vector<task*>& ready)
+{
+    if (now < m_start)
+        return 0;
+
+    auto const target = to_tick(now - m_start, false);
+    size_t fired{};
+    while (m_now <= target) {
+        // the cascade for a boundary tick happens as the tick is processed, so an advance which stopped
+        // on a boundary leaves it for the next call
+        if ((m_now & 0xFFFFFFFFULL) == 0)
+            cascade(OVERFLOW_BUCKET);
+        for (auto level = LEVELS - 1; level > 0; level--) {
+            if ((m_now & ((1ULL << (SLOT_BITS * level)) - 1)) == 0)
+                cascade(static_cast<uint32_t>(level * SLOTS + ((m_now >> (SLOT_BITS * level)) & (SLOTS - 1))));
+        }
+
+        if (m_level_sizes[0] != 0) {
+            fired += expire(static_cast<uint32_t>(m_now & (SLOTS - 1)), ready);
+            m_now++;
+            continue;
+        }
+
+        // nothing can fall due before the lowest occupied level next cascades, so jump straight to it
+        size_t level{1};
+        while (level <= LEVELS && m_level_sizes[level] == 0)
+            level++;
+        if (level > LEVELS) {
+            m_now = target + 1;
+            break;
+        }
+        auto const granularity = 1ULL << (SLOT_BITS * level);
+        auto const boundary = (m_now | (granularity - 1)) + 1;
+        m_now = boundary == 0 || boundary > target ? target + 1 : boundary;
+    }
+    return fired;
+}
+
+size_t timer_wheel::size() const noexcept
+{
+    return m_size;
+}
+
+timer_wheel::timer_wheel(clock::duration const resolution, clock::time_point const start, uint64_t const seed)
+    : m_resolution(resolution)
+    , m_start(start)
+    , m_random(seed)
+{
+    if (resolution <= clock::duration::zero())
+        throw std::invalid_argument("resolution must be positive");
+    m_buckets.fill(NONE);
+}
+
+uint64_t timer_wheel::to_tick(clock::duration const offset, bool const round_up) const noexcept
+{
+    if (offset <= clock::duration::zero())
+        return 0;
+    auto const ticks = static_cast<uint64_t>(offset / m_resolution);
+    return round_up && offset % m_resolution != clock::duration::zero()
+        ? ticks + 1
+        : ticks;
+}
+
+uint64_t timer_wheel::due_tick(timer const& entry) noexcept
+{
+    auto due = entry.scheduled;
+    if (entry.jitter > clock::duration::zero())
+        due += clock::duration(static_cast<clock::rep>(next_random(m_random) % static_cast<uint64_t>(entry.jitter.count())));
+    return to_tick(due, true);
+}
+
+void timer_wheel::insert(uint32_t const index)
+{
+    auto& entry = m_timers[index];
+    entry.due = std::max(entry.due, m_now);
+
+    // the level is the lowest whose slots span both the current tick and the due tick
+    auto const difference = entry.due ^ m_now;
+    uint32_t bucket{OVERFLOW_BUCKET};
+    for (size_t level = 0; level < LEVELS; level++) {
+        if ((difference >> (SLOT_BITS * (level + 1))) == 0) {
+            bucket = static_cast<uint32_t>(level * SLOTS + ((entry.due >> (SLOT_BITS * level)) & (SLOTS - 1)));
+            break;
+        }
+    }
+
+    entry.bucket = bucket;
+    entry.previous = NONE;
+    entry.next = m_buckets[bucket];
+    if (entry.next != NONE)
+        m_timers[entry.next].previous = index;
+    m_buckets[bucket] = index;
+    m_level_sizes[bucket / SLOTS]++;
+}
+
+void timer_wheel::unlink(uint32_t const index) noexcept
+{
+    auto& entry = m_timers[index];
+    if (entry.previous != NONE)
+        m_timers[entry.previous].next = entry.next;
+    else
+        m_buckets[entry.bucket] = entry.next;
+    if (entry.next != NONE)
+        m_timers[entry.next].previous = entry.previous;
+
+    m_level_sizes[entry.bucket / SLOTS]--;
+    entry.bucket = NONE;
+    entry.next = NONE;
+    entry.previous = NONE;
+}
+
+void timer_wheel::release(uint32_t const index) noexcept
+{
+    auto& entry = m_timers[index];
+    entry.work = nullptr;
+    entry.generation++;
+    entry.next = m_free;
+    m_free = index;
+    m_size--;
+}
+
+void timer_wheel::cascade(uint32_t const bucket)
+{
+    auto index = m_buckets[bucket];
+    while (index != NONE) {
+        auto const next = m_timers[index].next;
+        unlink(index);
+        insert(index);
+        index = next;
+    }
+}
+
+size_t timer_wheel::expire(uint32_t const bucket, vector<task*>& ready)
+{
+    size_t fired{};
+    auto index = m_buckets[bucket];
+    while (index != NONE) {
+        auto const next = m_timers[index].next;
+        unlink(index);
+
+        auto& entry = m_timers[index];
+        if (entry.work->mark_ready()) {
+            ready.push_back(entry.work);
+            fired++;
+        }
+
+        if (entry.period == clock::duration::zero()) {
+            release(index);
+        } else {
+            // step from the schedule rather than from now so the period never drifts, skipping any
+            // firings which were missed entirely rather than running them back to back
+            auto const elapsed = m_resolution * static_cast<clock::rep>(m_now);
+            entry.scheduled += entry.period;
+            if (entry.scheduled <= elapsed)
+                entry.scheduled += entry.period * ((elapsed - entry.scheduled) / entry.period + 1);
+            entry.due = due_tick(entry);
+            insert(index);
+        }
+        index = next;
+    }
+    return fired;
+}
+
+}
@@ -0,0 +1,154 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace tasks
+{
+    /// <summary>Chase-Lev deque, the owning thread pushes and pops at the bottom while any thread may steal from the top</summary>
+    /// <remarks>
+    /// follows the C11 formulation by Le, Pop, Cohen and Zappa Nardelli; the owner only contends with thieves
+    /// over the last item, so a worker busy with its own queue never takes a lock or a contended cache line.
+    /// the ring doubles when full and outgrown rings are kept until destruction since a thief may still be
+    /// reading one, which costs at most as much again as the largest ring
+    /// </remarks>
+    template <typename T>
+    class work_stealing_deque final
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "items are copied by racing threads so must be trivially copyable");
+
+    public:
+        /// <summary>adds value at the bottom, owner only</summary>
+        void push(T const value)
+        {
+            auto const bottom = m_bottom.load(std::memory_order_relaxed);
+            auto const top = m_top.load(std::memory_order_acquire);
+            auto* items = m_ring.load(std::memory_order_relaxed);
+            if (bottom - top > items->capacity - 1)
+                items = grow(items, bottom, top);
+            items->put(bottom, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        /// <summary>removes the most recently pushed value, owner only</summary>
+        [[nodiscard]] std::optional<T> pop()
+        {
+            auto const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            auto* const items = m_ring.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            auto const value = items->get(bottom);
+            if (top == bottom) {
+                // last item, race any thief for it
+                auto const won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                if (!won)
+                    return std::nullopt;
+            }
+            return value;
+        }
+
+        /// <summary>removes the oldest value, any thread</summary>
+        /// <remarks>may return nothing while items remain when it loses a race with another thread</remarks>
+        [[nodiscard]] std::optional<T> steal()
+        {
+            auto top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto const bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+                return std::nullopt;
+
+            auto const value = m_ring.load(std::memory_order_acquire)->get(top);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return std::nullopt;
+            return value;
+        }
+
+        /// <summary>number of items, exact only when no other thread is using the deque</summary>
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            auto const bottom = m_bottom.load(std::memory_order_relaxed);
+            auto const top = m_top.load(std::memory_order_relaxed);
+            return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+        }
+
+        explicit work_stealing_deque(std::int64_t const capacity = 256)
+        {
+            m_rings.push_back(std::make_unique<ring>(std::bit_ceil(static_cast<std::uint64_t>(std::max<std::int64_t>(capacity, 2)))));
+            m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+        }
+        work_stealing_deque(work_stealing_deque const&) = delete;
+        work_stealing_deque& operator=(work_stealing_deque const&) = delete;
+        work_stealing_deque(work_stealing_deque&&) = delete;
+        work_stealing_deque& operator=(work_stealing_deque&&) = delete;
+        ~work_stealing_deque() = default;
+
+    private:
+        struct ring
+        {
+            std::int64_t capacity;
+            std::int64_t mask;
+            std::unique_ptr<std::atomic<T>[]> items;
+
+            [[nodiscard]] T get(std::int64_t const index) const noexcept
+            {
+                return items[static_cast<std::size_t>(index & mask)].load(std::memory_order_relaxed);
+            }
+            void put(std::int64_t const index, T const value) noexcept
+            {
+                items[static_cast<std::size_t>(index & mask)].store(value, std::memory_order_relaxed);
+            }
+
+            explicit ring(std::uint64_t const size)
+                : capacity(static_cast<std::int64_t>(size))
+                , mask(static_cast<std::int64_t>(size) - 1)
+                , items(std::make_unique<std::atomic<T>[]>(static_cast<std::size_t>(size)))
+            {
+            }
+        };
+
+        // top and bottom on separate cache lines so thieves polling top don't slow the owner's pushes
+        alignas(64) std::atomic<std::int64_t> m_top{0};
+        alignas(64) std::atomic<std::int64_t> m_bottom{0};
+        alignas(64) std::atomic<ring*> m_ring{nullptr};
+        std::vector<std::unique_ptr<ring>> m_rings{};
+
+        ring* grow(ring const* const current, std::int64_t const bottom, std::int64_t const top)
+        {
+            auto next = std::make_unique<ring>(static_cast<std::uint64_t>(current->capacity) * 2);
+            for (auto index = top; index < bottom; index++)
+                next->put(index, current->get(index));
+            auto* const grown = next.get();
+            m_rings.push_back(std::move(next));
+            m_ring.store(grown, std::memory_order_release);
+            return grown;
+        }
+    };
+
+}
@@ -0,0 +1,71 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <module_path_cache.h>
+
+using std::filesystem::path;
+using std::optional;
+using std::vector;
+
+using shared::model::module_path_cache;
+using shared::model::process_change;
+using shared::model::process_delta;
+using shared::model::process_key;
+
+namespace shared::module_path_cache_tests
+{
+
+TEST(module_path_cache, resolves_each_process_once)
+{
+    module_path_cache cache{};
+    auto resolved = 0;
+    auto const resolve = [&resolved](process_key const&) {
+        resolved++;
+        return optional(path("/usr/bin/sleep"));
+    };
+
+    static_cast<void>(cache.get({7UL, 10ULL}, resolve));
+    auto const& cached = cache.get({7UL, 10ULL}, resolve);
+
+    ASSERT_EQ(1, resolved);
+    ASSERT_EQ(path("/usr/bin/sleep"), cached);
+}
+
+TEST(module_path_cache, reused_process_id_is_resolved_again)
+{
+    module_path_cache cache{};
+    static_cast<void>(cache.get({7UL, 10ULL}, [](auto const&) { return optional(path("/usr/bin/sleep")); }));
+
+    auto const& cached = cache.get({7UL, 99ULL}, [](auto const&) { return optional(path("/usr/bin/python3")); });
+
+    ASSERT_EQ(path("/usr/bin/python3"), cached);
+}
+
+TEST(module_path_cache, exited_processes_are_evicted)
+{
+    module_path_cache cache{};
+    static_cast<void>(cache.get({7UL, 10ULL}, [](auto const&) { return optional<path>(); }));
+    static_cast<void>(cache.get({8UL, 10ULL}, [](auto const&) { return optional(path("/bin/sh")); }));
+    vector<process_delta> const deltas{
+        {process_change::CHANGED, {8UL, 10ULL}, 1UL, 2UL, "sh"},
+        {process_change::EXITED, {7UL, 10ULL}, 1UL, 1UL, "sleep"}};
+
+    cache.apply(deltas);
+
+    ASSERT_EQ(nullptr, cache.find({7UL, 10ULL}));
+    ASSERT_NE(nullptr, cache.find({8UL, 10ULL}));
+    ASSERT_EQ(1ULL, cache.size());
+}
+
+}
@@ -0,0 +1,44 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <parallel_for.h>
+
+using std::vector;
+
+using shared::infrastructure::parallel_for;
+
+namespace shared::parallel_for_tests
+{
+
+TEST(parallel_for, visits_every_index_once)
+{
+    vector<int> visits(1000);
+
+    parallel_for(visits.size(), 4, [&visits](std::size_t const index) {
+        visits[index]++;
+    });
+
+    ASSERT_TRUE(std::all_of(begin(visits), end(visits), [](int const count) { return count == 1; }));
+}
+
+TEST(parallel_for, empty_range_runs_nothing)
+{
+    auto calls = 0;
+
+    parallel_for(0, 4, [&calls](std::size_t) { calls++; });
+
+    ASSERT_EQ(0, calls);
+}
+
+}
@@ -0,0 +1,68 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <proc_details.h>
+
+using std::filesystem::path;
+using std::vector;
+
+using shared::infrastructure::parse_proc_maps_modules;
+using shared::infrastructure::parse_proc_status;
+
+namespace shared::proc_details_tests
+{
+
+constexpr auto const SleepStatus =
+    "Name:\tsleep\n"
+    "State:\tS (sleeping)\n"
+    "VmRSS:\t     1920 kB\n"
+    "RssAnon:\t      96 kB\n"
+    "RssFile:\t    1824 kB\n"
+    "Threads:\t1\n";
+
+constexpr auto const SleepMaps =
+    "55d0c8a00000-55d0c8a02000 r--p 00000000 08:01 1311 /usr/bin/sleep\n"
+    "55d0c8a02000-55d0c8a06000 r-xp 00002000 08:01 1311 /usr/bin/sleep\n"
+    "55d0c9d6b000-55d0c9d8c000 rw-p 00000000 00:00 0                          [heap]\n"
+    "7f2a1c028000-7f2a1c1bd000 r-xp 00028000 08:01 2044                       /usr/lib/x86_64-linux-gnu/libc.so.6\n"
+    "7f2a1c1bd000-7f2a1c215000 r--p 001bd000 08:01 2044                       /usr/lib/x86_64-linux-gnu/libc.so.6\n"
+    "7f2a1c3a1000-7f2a1c3a4000 r-xp 00001000 08:01 2041                       /usr/lib/x86_64-linux-gnu/ld-linux-x86-64.so.2\n"
+    "7ffd3b9f2000-7ffd3b9f4000 r-xp 00000000 00:00 0                          [vdso]\n";
+
+TEST(proc_details, status_memory_lines_are_converted_to_bytes)
+{
+    auto const status = parse_proc_status(SleepStatus);
+
+    ASSERT_TRUE(status.has_value());
+    ASSERT_EQ(1UL, status->thread_count);
+    ASSERT_EQ(1920ULL * 1024ULL, status->resident_bytes);
+    ASSERT_EQ(96ULL * 1024ULL, status->anonymous_bytes);
+}
+
+TEST(proc_details, status_without_threads_is_rejected)
+{
+    ASSERT_FALSE(parse_proc_status("Name:\tsleep\nVmRSS:\t1920 kB\n").has_value());
+}
+
+TEST(proc_details, maps_modules_are_distinct_executable_files)
+{
+    auto const modules = parse_proc_maps_modules(SleepMaps);
+
+    ASSERT_EQ(vector<path>({
+        path("/usr/bin/sleep"),
+        path("/usr/lib/x86_64-linux-gnu/libc.so.6"),
+        path("/usr/lib/x86_64-linux-gnu/ld-linux-x86-64.so.2")}), modules);
+}
+
+}
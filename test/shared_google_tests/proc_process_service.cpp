@@ -0,0 +1,389 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+
+#ifdef __linux__
+
+#include <array>
+#include <process_service_impl.h>
+#include <proc_process_impl.h>
+#include <chrono>
+#include <thread>
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::optional;
+using std::string;
+using std::vector;
+
+using shared::infrastructure::proc_directory;
+using shared::infrastructure::proc_stat;
+using shared::model::proc_process_impl;
+using shared::model::process_start_info;
+using shared::model::unique_process;
+using shared::service::make_unique_process_service;
+
+#pragma warning(push)
+#pragma warning(disable:4455)
+using std::literals::string_literals::operator ""s;
+#pragma warning(pop)
+
+namespace shared::proc_process_service_tests
+{
+
+constexpr auto const ShellExe = "/bin/sh";
+constexpr auto const SleepExe = "/bin/sleep";
+
+TEST(proc_process_service, start_returns_null_when_file_not_found)
+{
+    auto const service = make_unique_process_service();
+
+    auto const process = service->start_process("/does/not/exist"s, ""s);
+
+    ASSERT_EQ(process, nullptr);
+}
+
+TEST(proc_process_service, exit_code_zero_with_good_command)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(ShellExe, "-c \"exit 0\"");
+
+    ASSERT_NE(process, nullptr);
+    process->wait_for_exit();
+
+    auto const exitCode = process->exit_code();
+    ASSERT_TRUE(exitCode.has_value());
+    ASSERT_EQ(0UL, exitCode.value());
+}
+
+TEST(proc_process_service, exit_code_non_zero_with_bad_command)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(ShellExe, "-c \"exit 3\"");
+
+    ASSERT_NE(process, nullptr);
+    process->wait_for_exit();
+
+    ASSERT_EQ(3UL, process->exit_code().value_or(0UL));
+}
+
+string read_all(unique_process const& process, bool const standard_error = false)
+{
+    string output{};
+    std::array<char, 16> buffer{};
+    for (;;) {
+        auto const count = standard_error
+            ? process->read_standard_error(buffer)
+            : process->read_standard_output(buffer);
+        if (count == 0)
+            return output;
+        output.append(buffer.data(), count);
+    }
+}
+
+TEST(proc_process_service, start_info_captures_standard_output)
+{
+    auto const service = make_unique_process_service();
+    process_start_info startInfo{ShellExe, {"-c", "echo hello; echo world"}};
+    startInfo.redirect_standard_output = true;
+
+    auto const process = service->start_process(startInfo);
+
+    ASSERT_NE(process, nullptr);
+    ASSERT_EQ("hello\nworld\n", read_all(process));
+    process->wait_for_exit();
+    ASSERT_EQ(0UL, process->exit_code().value_or(1UL));
+}
+
+TEST(proc_process_service, start_info_captures_standard_error_separately)
+{
+    auto const service = make_unique_process_service();
+    process_start_info startInfo{ShellExe, {"-c", "echo out; echo err >&2"}};
+    startInfo.redirect_standard_output = true;
+    startInfo.redirect_standard_error = true;
+
+    auto const process = service->start_process(startInfo);
+
+    ASSERT_NE(process, nullptr);
+    ASSERT_EQ("out\n", read_all(process));
+    ASSERT_EQ("err\n", read_all(process, true));
+}
+
+TEST(proc_process_service, start_info_passes_arguments_without_splitting)
+{
+    auto const service = make_unique_process_service();
+    process_start_info startInfo{ShellExe, {"-c", "echo \"$1\"", "sh", "two  spaced \"words\""}};
+    startInfo.redirect_standard_output = true;
+
+    auto const process = service->start_process(startInfo);
+
+    ASSERT_NE(process, nullptr);
+    ASSERT_EQ("two  spaced \"words\"\n", read_all(process));
+}
+
+TEST(proc_process_service, start_info_uses_explicit_environment)
+{
+    auto const service = make_unique_process_service();
+    process_start_info startInfo{ShellExe, {"-c", "echo \"$FOO:$HOME\""}};
+    startInfo.environment = vector<string>{"FOO=bar"};
+    startInfo.redirect_standard_output = true;
+
+    auto const process = service->start_process(startInfo);
+
+    ASSERT_NE(process, nullptr);
+    ASSERT_EQ("bar:\n", read_all(process));
+}
+
+TEST(proc_process_service, read_standard_output_returns_zero_when_not_redirected)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(ShellExe, "-c \"exit 0\"");
+    std::array<char, 4> buffer{};
+
+    ASSERT_NE(process, nullptr);
+    ASSERT_EQ(0ULL, process->read_standard_output(buffer));
+}
+
+TEST(proc_process_service, when_exited_completes_with_exit_code)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(ShellExe, "-c \"exit 5\"");
+
+    auto const exited = process->when_exited();
+
+    ASSERT_EQ(std::future_status::ready, exited.wait_for(std::chrono::seconds(10)));
+    ASSERT_EQ(5UL, exited.get().value_or(0UL));
+    ASSERT_EQ(5UL, process->exit_code().value_or(0UL));
+    ASSERT_FALSE(process->is_running());
+}
+
+TEST(proc_process_service, when_exited_watches_many_processes_from_one_reactor)
+{
+    auto const service = make_unique_process_service();
+    vector<shared::model::unique_process> processes{};
+    vector<shared::model::exit_future> exits{};
+    for (auto i = 0; i < 32; i++) {
+        processes.push_back(service->start_process(ShellExe, "-c \"exit " + std::to_string(i % 8) + "\""));
+        exits.push_back(processes.back()->when_exited());
+    }
+
+    for (std::size_t i = 0; i < exits.size(); i++)
+        ASSERT_EQ(i % 8, exits[i].get().value_or(99UL));
+}
+
+TEST(proc_process_service, when_exited_completes_without_exit_code_for_process_not_launched)
+{
+    // the shell forks sleep, so sleep is a grandchild which this process cannot reap
+    auto const service = make_unique_process_service();
+    auto const launched = service->start_process(ShellExe, "-c \"/bin/sleep 1; exit 0\"");
+    optional<proc_stat> grandchild{};
+    proc_directory directory{};
+    for (auto i = 0; i < 100 && !grandchild.has_value(); i++) {
+        directory.rewind();
+        proc_stat stat{};
+        while (directory.read_next(stat)) {
+            if (stat.parent_process_id == launched->get_id())
+                grandchild = stat;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(grandchild.has_value());
+
+    auto const exited = proc_process_impl::open({grandchild->process_id, grandchild->start_time})->when_exited();
+    ASSERT_NE(std::future_status::ready, exited.wait_for(std::chrono::seconds(0)));
+
+    ASSERT_EQ(std::future_status::ready, exited.wait_for(std::chrono::seconds(10)));
+    ASSERT_FALSE(exited.get().has_value());
+}
+
+bool process_exists(unsigned long const process_id)
+{
+    return std::filesystem::exists("/proc/" + std::to_string(process_id));
+}
+
+bool wait_until_gone(unsigned long const process_id)
+{
+    for (auto i = 0; i < 200 && process_exists(process_id); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    return !process_exists(process_id);
+}
+
+TEST(proc_process_service, dropping_kill_on_drop_process_kills_without_waiting)
+{
+    auto const service = make_unique_process_service();
+    auto process = service->start_process(SleepExe, "30", shared::model::process_ownership::KILL_ON_DROP);
+    auto const processId = process->get_id();
+    auto const start = steady_clock::now();
+
+    process.reset();
+
+    ASSERT_LT(duration<double>(steady_clock::now() - start).count(), 1.0);
+    ASSERT_TRUE(wait_until_gone(processId));
+}
+
+TEST(proc_process_service, dropping_detached_process_leaves_it_running_and_reaps_it)
+{
+    auto const service = make_unique_process_service();
+    auto process = service->start_process(SleepExe, "1");
+    auto const processId = process->get_id();
+    auto const start = steady_clock::now();
+
+    process.reset();
+
+    ASSERT_LT(duration<double>(steady_clock::now() - start).count(), 0.5);
+    ASSERT_TRUE(process_exists(processId));
+    ASSERT_TRUE(wait_until_gone(processId));
+}
+
+TEST(proc_process_service, waits_for_process_to_end)
+{
+    auto const service = make_unique_process_service();
+    auto const start = steady_clock::now();
+
+    auto const process = service->start_process(SleepExe, "1");
+    process->wait_for_exit();
+
+    ASSERT_GE(duration<double>(steady_clock::now() - start).count(), 1.0);
+}
+
+TEST(proc_process_service, process_by_name_finds_match)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "1");
+
+    auto const matchingProcesses = service->get_processes_by_name("sleep");
+    process->wait_for_exit();
+
+    ASSERT_TRUE(std::any_of(begin(matchingProcesses), end(matchingProcesses),
+        [&process](auto const& match) { return match->get_id() == process->get_id(); }));
+}
+
+TEST(proc_process_service, processes_by_names_returns_matches_in_request_order)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "1");
+
+    std::array<std::string_view, 3> const names{"no-such-process", "SLEEP", ""};
+    auto const matches = service->get_processes_by_names(names);
+    process->wait_for_exit();
+
+    ASSERT_EQ(3ULL, matches.size());
+    ASSERT_TRUE(matches[0].empty());
+    ASSERT_TRUE(std::any_of(begin(matches[1]), end(matches[1]),
+        [&process](auto const& match) { return match->get_id() == process->get_id(); }));
+    ASSERT_TRUE(matches[2].empty());
+}
+
+TEST(proc_process_service, no_processes_found_with_empty_process_name)
+{
+    auto const service = make_unique_process_service();
+
+    ASSERT_TRUE(service->get_processes_by_name(""s).empty());
+}
+
+TEST(proc_process_service, get_path_from_running_path_returns_path)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "1");
+
+    auto const path = service->get_path_to_running_process("sleep");
+    process->wait_for_exit();
+
+    ASSERT_TRUE(path.has_value());
+    ASSERT_EQ("sleep", path->filename().string().substr(0, 5));
+}
+
+TEST(proc_process_service, repeated_path_queries_return_the_cached_path)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "1");
+
+    auto const first = service->get_path_to_running_process("sleep");
+    auto const second = service->get_path_to_running_process("SLEEP");
+    process->wait_for_exit();
+
+    ASSERT_TRUE(first.has_value());
+    ASSERT_EQ(first, second);
+}
+
+TEST(proc_process_service, collect_details_returns_entries_in_request_order)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(SleepExe, "1");
+    vector<unsigned long> const processIds{process->get_id(), 0x7FFFFFF0UL, static_cast<unsigned long>(::getpid())};
+    // give the child time to finish exec, before then its maps are still being replaced
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    auto const details = service->collect_details(processIds);
+    process->wait_for_exit();
+
+    ASSERT_EQ(3ULL, details.size());
+    ASSERT_EQ(processIds[0], details[0].process_id);
+    ASSERT_TRUE(details[0].available);
+    ASSERT_FALSE(details[0].modules.empty());
+    ASSERT_EQ("sleep", details[0].modules.front().filename().string().substr(0, 5));
+    ASSERT_FALSE(details[1].available);
+    ASSERT_TRUE(details[2].available);
+    ASSERT_GT(details[2].thread_count, 0UL);
+    ASSERT_GT(details[2].resident_bytes, 0ULL);
+}
+
+TEST(proc_process_service, refresh_publishes_started_process)
+{
+    auto const service = make_unique_process_service();
+    service->refresh();
+    auto const process = service->start_process(SleepExe, "1");
+
+    bool started{};
+    auto const subscription = service->subscribe([&started, &process](auto const deltas) {
+        for (auto const& delta : deltas)
+            started |= delta.change == shared::model::process_change::STARTED && delta.key.process_id == process->get_id();
+    });
+    service->refresh();
+    service->unsubscribe(subscription);
+    process->wait_for_exit();
+
+    ASSERT_TRUE(started);
+}
+
+TEST(proc_process_service, throwing_subscriber_does_not_hide_started_process_from_name_lookup)
+{
+    auto const service = make_unique_process_service();
+    service->refresh();
+    auto const subscription = service->subscribe([](auto const) {
+        throw std::runtime_error("subscriber failed");
+    });
+    auto const process = service->start_process(SleepExe, "1");
+
+    service->refresh();
+    auto const matchingProcesses = service->get_processes_by_name("sleep");
+    service->unsubscribe(subscription);
+    process->wait_for_exit();
+
+    ASSERT_TRUE(std::any_of(begin(matchingProcesses), end(matchingProcesses),
+        [&process](auto const& match) { return match->get_id() == process->get_id(); }));
+}
+
+TEST(proc_process_service, split_arguments_honours_quotes)
+{
+    auto const arguments = proc_process_impl::split_arguments(R"(-c "echo one two"  three)");
+
+    ASSERT_EQ(3ULL, arguments.size());
+    ASSERT_EQ("echo one two"s, arguments[1]);
+    ASSERT_EQ("three"s, arguments[2]);
+}
+
+}
+
+#endif
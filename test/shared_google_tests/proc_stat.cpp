@@ -0,0 +1,67 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <proc_stat.h>
+
+using shared::infrastructure::parse_proc_stat;
+
+namespace shared::proc_stat_tests
+{
+
+constexpr auto const BashStat = "4242 (bash) S 4200 4242 4242 34816 4300 4194560 2612 11286 0 3 5 7 12 9 20 0 1 0 981234 10186752 1320 18446744073709551615 1 1 0 0 0 0 65536 3686404 1266761467 0 0 0 17 3 0 0 0 0 0\n";
+
+TEST(proc_stat, parses_process_and_parent_id)
+{
+    auto const stat = parse_proc_stat(BashStat);
+
+    ASSERT_TRUE(stat.has_value());
+    ASSERT_EQ(4242UL, stat->process_id);
+    ASSERT_EQ(4200UL, stat->parent_process_id);
+}
+
+TEST(proc_stat, parses_comm_state_and_counters)
+{
+    auto const stat = parse_proc_stat(BashStat);
+
+    ASSERT_TRUE(stat.has_value());
+    ASSERT_EQ("bash", stat->name());
+    ASSERT_EQ('S', stat->state);
+    ASSERT_EQ(5ULL, stat->user_time);
+    ASSERT_EQ(7ULL, stat->system_time);
+    ASSERT_EQ(1UL, stat->thread_count);
+    ASSERT_EQ(981234ULL, stat->start_time);
+    ASSERT_EQ(1320ULL, stat->resident_pages);
+}
+
+TEST(proc_stat, comm_containing_spaces_and_parenthesis_is_bounded_by_last_parenthesis)
+{
+    auto const stat = parse_proc_stat("17 (a) b (c) R 1 17 17 0 -1 4194560 0 0 0 0 1 2 0 0 20 0 3 0 55 0 9 18446744073709551615\n");
+
+    ASSERT_TRUE(stat.has_value());
+    ASSERT_EQ("a) b (c", stat->name());
+    ASSERT_EQ(3UL, stat->thread_count);
+    ASSERT_EQ(55ULL, stat->start_time);
+}
+
+TEST(proc_stat, truncated_content_is_rejected)
+{
+    ASSERT_FALSE(parse_proc_stat("4242 (bash) S 4200 4242").has_value());
+}
+
+TEST(proc_stat, missing_comm_is_rejected)
+{
+    ASSERT_FALSE(parse_proc_stat("4242 bash S 4200").has_value());
+}
+
+}
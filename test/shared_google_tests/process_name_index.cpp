@@ -0,0 +1,102 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <process_name_index.h>
+
+using std::string_view;
+using std::vector;
+
+using shared::model::process_change;
+using shared::model::process_delta;
+using shared::model::process_key;
+using shared::model::process_name_index;
+
+namespace shared::process_name_index_tests
+{
+
+process_delta delta_of(process_change const change, unsigned long const process_id, string_view const name)
+{
+    return {change, {process_id, 10ULL}, 1UL, 1UL, name};
+}
+
+vector<unsigned long> process_ids_of(std::span<process_key const> const keys)
+{
+    vector<unsigned long> process_ids{};
+    for (auto const& key : keys)
+        process_ids.push_back(key.process_id);
+    std::sort(begin(process_ids), end(process_ids));
+    return process_ids;
+}
+
+TEST(process_name_index, find_ignores_ascii_case)
+{
+    process_name_index index{};
+    vector<process_delta> const deltas{
+        delta_of(process_change::STARTED, 1UL, "Notepad.exe"),
+        delta_of(process_change::STARTED, 2UL, "notepad.EXE"),
+        delta_of(process_change::STARTED, 3UL, "explorer.exe")};
+
+    index.apply(deltas);
+
+    ASSERT_EQ(vector<unsigned long>({1UL, 2UL}), process_ids_of(index.find("NOTEPAD.exe")));
+    ASSERT_TRUE(index.find("").empty());
+}
+
+TEST(process_name_index, exited_processes_are_removed)
+{
+    process_name_index index{};
+    vector<process_delta> const started{
+        delta_of(process_change::STARTED, 1UL, "sshd"),
+        delta_of(process_change::STARTED, 2UL, "sshd")};
+    vector<process_delta> const exited{delta_of(process_change::EXITED, 1UL, "sshd")};
+    index.apply(started);
+
+    index.apply(exited);
+
+    ASSERT_EQ(vector<unsigned long>({2UL}), process_ids_of(index.find("sshd")));
+    ASSERT_EQ(1ULL, index.size());
+}
+
+TEST(process_name_index, renamed_process_moves_to_new_name)
+{
+    process_name_index index{};
+    vector<process_delta> const started{delta_of(process_change::STARTED, 4UL, "sh")};
+    vector<process_delta> const changed{delta_of(process_change::CHANGED, 4UL, "python")};
+    index.apply(started);
+
+    index.apply(changed);
+
+    ASSERT_TRUE(index.find("sh").empty());
+    ASSERT_EQ(vector<unsigned long>({4UL}), process_ids_of(index.find("Python")));
+}
+
+TEST(process_name_index, long_names_are_found_by_truncated_prefix)
+{
+    process_name_index index(15);
+    vector<process_delta> const deltas{delta_of(process_change::STARTED, 5UL, "application_mon")};
+
+    index.apply(deltas);
+
+    ASSERT_EQ(vector<unsigned long>({5UL}), process_ids_of(index.find("application_monitor")));
+}
+
+TEST(process_name_index, matches_ignores_case_and_truncation)
+{
+    ASSERT_TRUE(process_name_index::matches("systemd-journald", "systemd-journal", 15));
+    ASSERT_TRUE(process_name_index::matches("BASH", "bash", 15));
+    ASSERT_FALSE(process_name_index::matches("bas", "bash", 15));
+    ASSERT_FALSE(process_name_index::matches("", "", 15));
+}
+
+}
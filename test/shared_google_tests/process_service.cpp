@@ -13,12 +13,15 @@
 
 #include "pch.h"
 #include <process_service_impl.h>
+#include <array>
 #include <chrono>
+#include <Windows.h>
 
 using std::chrono::duration;
 using std::chrono::steady_clock;
 using std::filesystem::path;
 
+using shared::model::process_start_info;
 using shared::service::make_unique_process_service;
 
 #pragma warning(push)
@@ -67,10 +70,65 @@ TEST(process_service, exit_code_non_zero_with_bad_command)
 
 #   ifdef _WIN64
 constexpr auto const CommandExe = R"(c:\windows\system32\cmd.exe)";
+constexpr auto const PingExe = R"(c:\windows\system32\ping.exe)";
 #   else
 constexpr auto const CommandExe = R"(c:\windows\SysWOW64\cmd.exe)";
+constexpr auto const PingExe = R"(c:\windows\SysWOW64\ping.exe)";
 #   endif
 
+/// <summary>true once process_id has exited, waiting up to five seconds for it to</summary>
+bool wait_until_gone(unsigned long const process_id)
+{
+    auto* const handle = OpenProcess(SYNCHRONIZE, FALSE, process_id);
+    if (handle == nullptr)
+        return GetLastError() == ERROR_INVALID_PARAMETER;
+    auto const gone = WaitForSingleObject(handle, 5000) == WAIT_OBJECT_0;
+    CloseHandle(handle);
+    return gone;
+}
+
+TEST(process_service, start_info_captures_standard_output)
+{
+    auto const service = make_unique_process_service();
+    process_start_info startInfo{CommandExe, {"/c", "echo hello"}};
+    startInfo.redirect_standard_output = true;
+
+    auto const process = service->start_process(startInfo);
+
+    ASSERT_NE(process, nullptr);
+    std::string output{};
+    std::array<char, 16> buffer{};
+    for (auto count = process->read_standard_output(buffer); count != 0; count = process->read_standard_output(buffer))
+        output.append(buffer.data(), count);
+    ASSERT_EQ("hello\r\n", output);
+}
+
+TEST(process_service, when_exited_completes_with_exit_code)
+{
+    auto const service = make_unique_process_service();
+    auto const process = service->start_process(CommandExe, "/c exit 5");
+
+    auto const exited = process->when_exited();
+
+    ASSERT_EQ(std::future_status::ready, exited.wait_for(std::chrono::seconds(10)));
+    ASSERT_EQ(5UL, exited.get().value_or(0UL));
+}
+
+TEST(process_service, dropping_kill_on_drop_process_does_not_wait)
+{
+    auto const service = make_unique_process_service();
+    // ping waits a second between echoes, so unlike cmd /c it lives for the whole 30 seconds on its own
+    auto process = service->start_process(PingExe, "-n 30 127.0.0.1", shared::model::process_ownership::KILL_ON_DROP);
+    ASSERT_NE(process, nullptr);
+    auto const processId = process->get_id();
+    auto const start = steady_clock::now();
+
+    process.reset();
+
+    ASSERT_LT(duration<double>(steady_clock::now() - start).count(), 1.0);
+    ASSERT_TRUE(wait_until_gone(processId));
+}
+
 TEST(process_service, exit_code_zero_with_good_command)
 {
     // Assert / Act
@@ -0,0 +1,167 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <process_table.h>
+#include <stdexcept>
+
+using std::span;
+using std::string;
+using std::vector;
+
+using shared::infrastructure::process_entry;
+using shared::infrastructure::process_entry_reader;
+using shared::model::process_change;
+using shared::model::process_delta;
+using shared::model::process_key;
+using shared::model::process_table;
+
+namespace shared::process_table_tests
+{
+
+class fixed_entry_reader final : public process_entry_reader
+{
+public:
+    vector<process_entry> entries{};
+
+    void rewind() override
+    {
+        m_position = 0;
+    }
+    bool read_next(process_entry& entry) override
+    {
+        if (m_position >= entries.size())
+            return false;
+        entry = entries[m_position++];
+        return true;
+    }
+private:
+    std::size_t m_position{};
+};
+
+vector<process_change> changes_of(span<process_delta const> const deltas)
+{
+    vector<process_change> changes{};
+    for (auto const& delta : deltas)
+        changes.push_back(delta.change);
+    return changes;
+}
+
+TEST(process_table, first_refresh_reports_every_process_as_started)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    reader.entries = {{1UL, 0UL, 10ULL, 1UL, "init"}, {2UL, 1UL, 20ULL, 4UL, "sshd"}};
+
+    auto const deltas = table.refresh(reader);
+
+    ASSERT_EQ(vector<process_change>({process_change::STARTED, process_change::STARTED}), changes_of(deltas));
+    ASSERT_EQ(2ULL, table.size());
+}
+
+TEST(process_table, unchanged_processes_produce_no_deltas)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    reader.entries = {{1UL, 0UL, 10ULL, 1UL, "init"}};
+    static_cast<void>(table.refresh(reader));
+
+    ASSERT_TRUE(table.refresh(reader).empty());
+}
+
+TEST(process_table, missing_process_is_reported_as_exited_with_its_name)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    reader.entries = {{1UL, 0UL, 10ULL, 1UL, "init"}, {2UL, 1UL, 20ULL, 4UL, "sshd"}};
+    static_cast<void>(table.refresh(reader));
+    reader.entries.pop_back();
+
+    auto const deltas = table.refresh(reader);
+
+    ASSERT_EQ(1ULL, deltas.size());
+    ASSERT_EQ(process_change::EXITED, deltas[0].change);
+    ASSERT_EQ("sshd", deltas[0].name);
+    ASSERT_EQ(1ULL, table.size());
+}
+
+TEST(process_table, reused_process_id_is_reported_as_exit_and_start)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    reader.entries = {{7UL, 1UL, 10ULL, 1UL, "worker"}};
+    static_cast<void>(table.refresh(reader));
+    reader.entries = {{7UL, 1UL, 99ULL, 1UL, "other"}};
+
+    auto const deltas = table.refresh(reader);
+
+    ASSERT_EQ(vector<process_change>({process_change::STARTED, process_change::EXITED}), changes_of(deltas));
+    ASSERT_EQ((process_key{7UL, 99ULL}), deltas[0].key);
+    ASSERT_EQ((process_key{7UL, 10ULL}), deltas[1].key);
+}
+
+TEST(process_table, thread_count_or_name_change_is_reported_as_changed)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    reader.entries = {{3UL, 1UL, 10ULL, 1UL, "sh"}};
+    static_cast<void>(table.refresh(reader));
+    reader.entries = {{3UL, 1UL, 10ULL, 1UL, "python"}};
+
+    auto const deltas = table.refresh(reader);
+
+    ASSERT_EQ(1ULL, deltas.size());
+    ASSERT_EQ(process_change::CHANGED, deltas[0].change);
+    ASSERT_EQ("python", deltas[0].name);
+}
+
+TEST(process_table, subscribers_receive_deltas_until_unsubscribed)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    vector<string> started{};
+    auto const subscription = table.subscribe([&started](span<process_delta const> const deltas) {
+        for (auto const& delta : deltas)
+            started.emplace_back(delta.name);
+    });
+
+    reader.entries = {{1UL, 0UL, 10ULL, 1UL, "init"}};
+    static_cast<void>(table.refresh(reader));
+    table.unsubscribe(subscription);
+    reader.entries.push_back({2UL, 1UL, 20ULL, 1UL, "cron"});
+    static_cast<void>(table.refresh(reader));
+
+    ASSERT_EQ(vector<string>({"init"}), started);
+}
+
+TEST(process_table, throwing_subscriber_does_not_stop_the_others)
+{
+    process_table table{};
+    fixed_entry_reader reader{};
+    vector<string> started{};
+    static_cast<void>(table.subscribe([](span<process_delta const> const) {
+        throw std::runtime_error("subscriber failed");
+    }));
+    static_cast<void>(table.subscribe([&started](span<process_delta const> const deltas) {
+        for (auto const& delta : deltas)
+            started.emplace_back(delta.name);
+    }));
+
+    reader.entries = {{1UL, 0UL, 10ULL, 1UL, "init"}};
+    auto const deltas = table.refresh(reader);
+
+    ASSERT_EQ(1ULL, deltas.size());
+    ASSERT_EQ(vector<string>({"init"}), started);
+}
+
+}
@@ -0,0 +1,231 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <resource_sampler_impl.h>
+#include <thread>
+
+using std::optional;
+using std::vector;
+
+using shared::infrastructure::read_result;
+using shared::infrastructure::resource_reader;
+using shared::model::exit_future;
+using shared::model::process_key;
+using shared::model::resource_sample;
+using shared::model::unique_process;
+using shared::service::resource_sampler_impl;
+
+namespace shared::resource_sampler_tests
+{
+
+class fixed_process final : public shared::model::process
+{
+public:
+    explicit fixed_process(unsigned long const process_id)
+        : m_process_id(process_id)
+    {
+    }
+    [[nodiscard]] unsigned long get_id() const noexcept override
+    {
+        return m_process_id;
+    }
+    [[nodiscard]] bool is_running() const noexcept override
+    {
+        return true;
+    }
+    [[nodiscard]] optional<unsigned long> exit_code() const noexcept override
+    {
+        return std::nullopt;
+    }
+    void wait_for_exit() const noexcept override
+    {
+    }
+    [[nodiscard]] exit_future when_exited() const override
+    {
+        return exit_future();
+    }
+    [[nodiscard]] std::size_t read_standard_output(std::span<char> const) const noexcept override
+    {
+        return 0;
+    }
+    [[nodiscard]] std::size_t read_standard_error(std::span<char> const) const noexcept override
+    {
+        return 0;
+    }
+    [[nodiscard]] optional<std::filesystem::path> get_path_to_running_process(std::string_view const&) const noexcept override
+    {
+        return std::nullopt;
+    }
+private:
+    unsigned long m_process_id;
+};
+
+class counting_reader final : public resource_reader
+{
+public:
+    unsigned long rounds{};
+    unsigned long long start_offset{};
+    vector<unsigned long> exited{};
+    vector<unsigned long> unavailable{};
+
+    void begin_round() override
+    {
+        rounds++;
+    }
+    [[nodiscard]] optional<unsigned long long> get_start_time(unsigned long const process_id) override
+    {
+        return optional(process_id * 10ULL + start_offset);
+    }
+    [[nodiscard]] read_result read(process_key const& key, resource_sample& sample) override
+    {
+        if (std::find(begin(exited), end(exited), key.process_id) != end(exited))
+            return read_result::EXITED;
+        if (std::find(begin(unavailable), end(unavailable), key.process_id) != end(unavailable))
+            return read_result::UNAVAILABLE;
+        sample.thread_count = rounds;
+        sample.handle_count = key.process_id;
+        return read_result::SAMPLED;
+    }
+};
+
+struct sampler_fixture
+{
+    counting_reader* reader;
+    resource_sampler_impl sampler;
+
+    explicit sampler_fixture(std::size_t const capacity)
+        : sampler_fixture(capacity, std::make_unique<counting_reader>())
+    {
+    }
+private:
+    sampler_fixture(std::size_t const capacity, std::unique_ptr<counting_reader> owned)
+        : reader(owned.get())
+        , sampler(capacity, std::move(owned))
+    {
+    }
+};
+
+vector<unsigned long> rounds_of(vector<resource_sample> const& samples)
+{
+    vector<unsigned long> rounds{};
+    for (auto const& sample : samples)
+        rounds.push_back(sample.thread_count);
+    return rounds;
+}
+
+TEST(resource_sampler, keeps_most_recent_samples_oldest_first)
+{
+    sampler_fixture fixture(3);
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+
+    for (auto i = 0; i < 5; i++)
+        fixture.sampler.sample();
+
+    ASSERT_EQ(vector<unsigned long>({3UL, 4UL, 5UL}), rounds_of(fixture.sampler.get_samples(4UL)));
+}
+
+TEST(resource_sampler, exited_targets_keep_samples_but_are_no_longer_sampled)
+{
+    sampler_fixture fixture(8);
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(5UL)));
+    fixture.sampler.sample();
+    fixture.reader->exited.push_back(4UL);
+
+    fixture.sampler.sample();
+
+    ASSERT_EQ(vector<unsigned long>({1UL}), rounds_of(fixture.sampler.get_samples(4UL)));
+    ASSERT_EQ(vector<unsigned long>({1UL, 2UL}), rounds_of(fixture.sampler.get_samples(5UL)));
+}
+
+TEST(resource_sampler, unavailable_read_skips_the_round_but_keeps_sampling)
+{
+    sampler_fixture fixture(8);
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+    fixture.sampler.sample();
+    fixture.reader->unavailable.push_back(4UL);
+    fixture.sampler.sample();
+    fixture.reader->unavailable.clear();
+
+    fixture.sampler.sample();
+
+    ASSERT_EQ(vector<unsigned long>({1UL, 3UL}), rounds_of(fixture.sampler.get_samples(4UL)));
+}
+
+TEST(resource_sampler, zero_samples_per_process_throws_invalid_argument)
+{
+    ASSERT_THROW(resource_sampler_impl(0, std::make_unique<counting_reader>()), std::invalid_argument);
+}
+
+TEST(resource_sampler, duplicate_targets_are_rejected)
+{
+    sampler_fixture fixture(8);
+
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+    ASSERT_FALSE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+    fixture.sampler.remove(4UL);
+    ASSERT_EQ(0ULL, fixture.sampler.size());
+}
+
+TEST(resource_sampler, reused_process_id_replaces_the_exited_target)
+{
+    sampler_fixture fixture(8);
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+    fixture.sampler.sample();
+    fixture.reader->exited.push_back(4UL);
+    fixture.sampler.sample();
+    fixture.reader->exited.clear();
+    fixture.reader->start_offset = 1ULL;
+
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+    fixture.sampler.sample();
+
+    ASSERT_EQ(1ULL, fixture.sampler.size());
+    ASSERT_EQ(vector<unsigned long>({3UL}), rounds_of(fixture.sampler.get_samples(4UL)));
+}
+
+TEST(resource_sampler, start_samples_on_interval_until_stopped)
+{
+    sampler_fixture fixture(64);
+    ASSERT_TRUE(fixture.sampler.add(std::make_unique<fixed_process>(4UL)));
+
+    fixture.sampler.start(std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    fixture.sampler.stop();
+    auto const taken = fixture.sampler.get_samples(4UL).size();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    ASSERT_GE(taken, 5ULL);
+    ASSERT_EQ(taken, fixture.sampler.get_samples(4UL).size());
+}
+
+#ifdef __linux__
+
+TEST(resource_sampler, reads_counters_of_this_process)
+{
+    auto const sampler = shared::service::make_resource_sampler(4);
+    ASSERT_TRUE(sampler->add(std::make_unique<fixed_process>(static_cast<unsigned long>(::getpid()))));
+
+    sampler->sample();
+    auto const samples = sampler->get_samples(static_cast<unsigned long>(::getpid()));
+
+    ASSERT_EQ(1ULL, samples.size());
+    ASSERT_GT(samples[0].resident_bytes, 0ULL);
+    ASSERT_GT(samples[0].thread_count, 0UL);
+    ASSERT_GT(samples[0].handle_count, 0UL);
+}
+
+#endif
+
+}
@@ -0,0 +1,52 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include "shared/ring_buffer.h"
+
+using shared::infrastructure::ring_buffer;
+
+namespace shared::ring_buffer_tests
+{
+
+TEST(ring_buffer, keeps_values_in_push_order_until_full)
+{
+    ring_buffer<int> buffer(3);
+
+    buffer.push(1);
+    buffer.push(2);
+
+    ASSERT_EQ(2ULL, buffer.size());
+    ASSERT_EQ(1, buffer[0]);
+    ASSERT_EQ(2, buffer.back());
+}
+
+TEST(ring_buffer, overwrites_oldest_once_full)
+{
+    ring_buffer<int> buffer(3);
+
+    for (auto value = 1; value <= 5; value++)
+        buffer.push(value);
+
+    ASSERT_EQ(3ULL, buffer.size());
+    ASSERT_EQ(3, buffer[0]);
+    ASSERT_EQ(4, buffer[1]);
+    ASSERT_EQ(5, buffer.back());
+}
+
+TEST(ring_buffer, zero_capacity_throws_invalid_argument)
+{
+    ASSERT_THROW(ring_buffer<int>(0), std::invalid_argument);
+}
+
+}
@@ -0,0 +1,183 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <allocation_query.h>
+#include "fixtures.h"
+
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using snapshot::model::allocation_change;
+using snapshot::model::allocation_order;
+using snapshot::model::allocation_query;
+using snapshot::model::diff_snapshots;
+using snapshot::model::heap_snapshot;
+using snapshot::model::module_total;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+using snapshot::tests::make_snapshot;
+
+namespace snapshot::allocation_query_tests
+{
+
+class allocation_query_test : public testing::Test
+{
+protected:
+    shared_ptr<trace_store> traces = make_shared<trace_store>();
+    trace_id cache_insert{};
+    trace_id cache_evict{};
+    trace_id session_open{};
+    trace_id worker_run{};
+
+    void SetUp() override
+    {
+        cache_insert = intern({"ntdll!RtlAllocateHeap+20", "cache!cache::insert+42", "app!main+5"});
+        cache_evict = intern({"ntdll!RtlAllocateHeap+20", "cache!cache::evict+10", "app!main+5"});
+        session_open = intern({"ucrtbase!malloc+36", "net!session::open+110", "app!main+5"});
+        worker_run = intern({"app!worker::run+11"});
+    }
+
+    [[nodiscard]] trace_id intern(vector<string_view> const& frames) const
+    {
+        return traces->intern_trace(frames);
+    }
+    [[nodiscard]] string module_of(module_total const& total) const
+    {
+        return string(traces->module(total.module));
+    }
+};
+
+vector<trace_id> traces_of(vector<allocation_change> const& rows)
+{
+    vector<trace_id> ids{};
+    for (auto const& row : rows)
+        ids.push_back(row.trace);
+    return ids;
+}
+
+TEST_F(allocation_query_test, top_returns_largest_rows_first)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 1ULL}, {cache_evict, 100ULL, 9ULL}, {session_open, 500ULL, 2ULL}, {worker_run, 200ULL, 4ULL}});
+    allocation_query const query(snapshot);
+
+    ASSERT_EQ(vector<trace_id>({session_open, cache_insert}), traces_of(query.top(2, allocation_order::BYTES)));
+    ASSERT_EQ(vector<trace_id>({cache_evict, worker_run, session_open}), traces_of(query.top(3, allocation_order::COUNT)));
+    ASSERT_EQ(4ULL, query.top(10, allocation_order::BYTES).size());
+    ASSERT_TRUE(query.top(0, allocation_order::BYTES).empty());
+}
+
+TEST_F(allocation_query_test, equal_values_rank_by_trace)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 100ULL, 1ULL}, {cache_evict, 100ULL, 1ULL}, {session_open, 100ULL, 1ULL}});
+
+    ASSERT_EQ(vector<trace_id>({cache_insert, cache_evict}), traces_of(allocation_query(snapshot).top(2, allocation_order::BYTES)));
+}
+
+TEST_F(allocation_query_test, growth_ranks_diff_rows_which_grew)
+{
+    auto const before = make_snapshot(traces, {{cache_insert, 100ULL, 1ULL}, {cache_evict, 900ULL, 9ULL}, {session_open, 100ULL, 1ULL}});
+    auto const after = make_snapshot(traces, {{cache_insert, 600ULL, 6ULL}, {cache_evict, 100ULL, 1ULL}, {session_open, 300ULL, 3ULL}});
+    auto const diff = diff_snapshots(before, after);
+
+    auto const grown = allocation_query(diff).top(5, allocation_order::GROWTH);
+
+    ASSERT_EQ(vector<trace_id>({cache_insert, session_open}), traces_of(grown));
+    ASSERT_EQ(500LL, grown[0].bytes_delta);
+    ASSERT_EQ(5LL, grown[0].count_delta);
+}
+
+TEST_F(allocation_query_test, snapshot_growth_is_its_size)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 3ULL}});
+
+    auto const grown = allocation_query(snapshot).top(1, allocation_order::GROWTH);
+
+    ASSERT_EQ(1ULL, grown.size());
+    ASSERT_EQ(300LL, grown[0].bytes_delta);
+    ASSERT_EQ(3LL, grown[0].count_delta);
+}
+
+TEST_F(allocation_query_test, module_filter_matches_attributed_module_ignoring_case)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 1ULL}, {cache_evict, 100ULL, 1ULL}, {session_open, 500ULL, 1ULL}});
+
+    ASSERT_EQ(vector<trace_id>({cache_insert, cache_evict}), traces_of(allocation_query(snapshot).where_module("CACHE").top(5, allocation_order::BYTES)));
+    ASSERT_TRUE(allocation_query(snapshot).where_module("ntdll").top(5, allocation_order::BYTES).empty());
+    ASSERT_TRUE(allocation_query(snapshot).where_module("missing").top(5, allocation_order::BYTES).empty());
+}
+
+TEST_F(allocation_query_test, function_filter_matches_any_frame_by_name)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 1ULL}, {cache_evict, 100ULL, 1ULL}, {session_open, 500ULL, 1ULL}, {worker_run, 50ULL, 1ULL}});
+
+    ASSERT_EQ(vector<trace_id>({session_open, cache_insert, cache_evict}), traces_of(allocation_query(snapshot).where_function("main").top(5, allocation_order::BYTES)));
+    ASSERT_EQ(vector<trace_id>({cache_evict}), traces_of(allocation_query(snapshot).where_function("::evict").top(5, allocation_order::BYTES)));
+    ASSERT_TRUE(allocation_query(snapshot).where_function("+42").top(5, allocation_order::BYTES).empty());
+}
+
+TEST_F(allocation_query_test, by_module_totals_rows_per_attributed_module)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 1ULL}, {cache_evict, 100ULL, 2ULL}, {session_open, 500ULL, 1ULL}, {worker_run, 50ULL, 1ULL}});
+    allocation_query const query(snapshot);
+
+    auto const modules = query.by_module(allocation_order::BYTES);
+
+    ASSERT_EQ(3ULL, modules.size());
+    ASSERT_EQ("net", module_of(modules[0]));
+    ASSERT_EQ("cache", module_of(modules[1]));
+    ASSERT_EQ(400ULL, modules[1].bytes);
+    ASSERT_EQ(3ULL, modules[1].count);
+    ASSERT_EQ(2ULL, modules[1].traces);
+    ASSERT_EQ("app", module_of(modules[2]));
+    ASSERT_EQ("cache", module_of(query.by_module(allocation_order::COUNT, 1)[0]));
+}
+
+TEST_F(allocation_query_test, by_module_uses_snapshot_rollup_when_unfiltered)
+{
+    auto snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 1ULL}, {cache_evict, 100ULL, 2ULL}, {session_open, 500ULL, 1ULL}});
+    snapshot.roll_up();
+    snapshot.modules[0].bytes = 1000ULL;
+
+    auto const modules = allocation_query(snapshot).by_module(allocation_order::BYTES, 1);
+
+    ASSERT_EQ(snapshot.modules[0].module, modules[0].module);
+    ASSERT_EQ(1000ULL, modules[0].bytes);
+    ASSERT_EQ(400ULL, allocation_query(snapshot).where_function("cache::").by_module(allocation_order::BYTES)[0].bytes);
+}
+
+TEST_F(allocation_query_test, by_module_applies_filters)
+{
+    auto const snapshot = make_snapshot(traces, {{cache_insert, 300ULL, 1ULL}, {cache_evict, 100ULL, 2ULL}, {session_open, 500ULL, 1ULL}});
+    allocation_query query(snapshot);
+    static_cast<void>(query.by_module(allocation_order::BYTES));
+
+    auto const modules = query.where_function("evict").by_module(allocation_order::BYTES);
+
+    ASSERT_EQ(1ULL, modules.size());
+    ASSERT_EQ("cache", module_of(modules[0]));
+    ASSERT_EQ(100ULL, modules[0].bytes);
+}
+
+TEST_F(allocation_query_test, empty_snapshot_has_no_rows)
+{
+    heap_snapshot const snapshot{};
+
+    ASSERT_TRUE(allocation_query(snapshot).top(5, allocation_order::BYTES).empty());
+    ASSERT_TRUE(allocation_query(snapshot).where_module("app").by_module(allocation_order::BYTES).empty());
+}
+
+}
@@ -0,0 +1,75 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <collapsed_stacks.h>
+#include <sstream>
+#include "fixtures.h"
+
+using std::make_shared;
+using std::string_view;
+using std::vector;
+
+using snapshot::model::diff_snapshots;
+using snapshot::model::heap_snapshot;
+using snapshot::model::stack_weight;
+using snapshot::model::trace_store;
+using snapshot::model::write_collapsed_stacks;
+using snapshot::tests::make_snapshot;
+
+namespace snapshot::collapsed_stacks_tests
+{
+
+TEST(collapsed_stacks, snapshot_rows_are_written_root_first)
+{
+    auto const traces = make_shared<trace_store>();
+    auto const cache = traces->intern_trace(vector<string_view>{"ntdll!RtlAllocateHeap+00000020", "app!cache::insert+00000042", "app!main+00000005"});
+    auto const worker = traces->intern_trace(vector<string_view>{"7FFB2C6E6D3B", "app!worker::run+00000011"});
+    auto const empty = traces->intern_trace(vector<string_view>{});
+    auto const snapshot = make_snapshot(traces, {{cache, 300ULL, 3ULL}, {worker, 40ULL, 1ULL}, {empty, 0ULL, 0ULL}});
+    std::ostringstream bytes{};
+    std::ostringstream counts{};
+
+    ASSERT_EQ(2ULL, write_collapsed_stacks(bytes, snapshot));
+    ASSERT_EQ(2ULL, write_collapsed_stacks(counts, snapshot, stack_weight::COUNT));
+    ASSERT_EQ("app!main;app!cache::insert;ntdll!RtlAllocateHeap 300\napp!worker::run;7FFB2C6E6D3B 40\n", bytes.str());
+    ASSERT_EQ("app!main;app!cache::insert;ntdll!RtlAllocateHeap 3\napp!worker::run;7FFB2C6E6D3B 1\n", counts.str());
+}
+
+TEST(collapsed_stacks, diff_rows_are_weighted_by_growth)
+{
+    auto const traces = make_shared<trace_store>();
+    auto const grew = traces->intern_trace(vector<string_view>{"app!grow+1"});
+    auto const shrank = traces->intern_trace(vector<string_view>{"app!shrink+1"});
+    auto const appeared = traces->intern_trace(vector<string_view>{"app!new+1"});
+    auto const diff = diff_snapshots(
+        make_snapshot(traces, {{grew, 100ULL, 1ULL}, {shrank, 500ULL, 5ULL}}),
+        make_snapshot(traces, {{grew, 250ULL, 4ULL}, {shrank, 100ULL, 1ULL}, {appeared, 30ULL, 1ULL}}));
+    std::ostringstream stream{};
+
+    ASSERT_EQ(2ULL, write_collapsed_stacks(stream, diff));
+    ASSERT_EQ("app!grow 150\napp!new 30\n", stream.str());
+}
+
+TEST(collapsed_stacks, separators_in_frames_are_escaped)
+{
+    auto const traces = make_shared<trace_store>();
+    auto const odd = traces->intern_trace(vector<string_view>{"app!f;g+1"});
+    std::ostringstream stream{};
+
+    static_cast<void>(write_collapsed_stacks(stream, make_snapshot(traces, {{odd, 8ULL, 1ULL}})));
+
+    ASSERT_EQ("app!f:g 8\n", stream.str());
+}
+
+}
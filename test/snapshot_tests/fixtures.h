@@ -0,0 +1,40 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <heap_snapshot.h>
+#include <trace_store.h>
+
+namespace snapshot::tests
+{
+    /// <summary>path to a file under the fixtures directory next to this header</summary>
+    inline std::filesystem::path fixture_path(std::string_view const name)
+    {
+        return std::filesystem::path(__FILE__).parent_path() / "fixtures" / name;
+    }
+
+    /// <summary>snapshot holding rows, in order, of backtraces interned in traces</summary>
+    inline model::heap_snapshot make_snapshot(std::shared_ptr<model::trace_store const> const& traces, std::vector<model::allocation> const& rows)
+    {
+        model::heap_snapshot snapshot{};
+        snapshot.traces = traces;
+        for (auto const& row : rows)
+            snapshot.append(row);
+        return snapshot;
+    }
+}
@@ -0,0 +1,130 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <frame_rules.h>
+#include <trace_store.h>
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+using snapshot::model::frame_rules;
+using snapshot::model::trace_store;
+
+namespace snapshot::frame_rules_tests
+{
+
+vector<string> rewrite(frame_rules rules, vector<string_view> const& frames)
+{
+    trace_store store(std::move(rules));
+    auto const trace = store.intern_trace(frames);
+    vector<string> rewritten{};
+    for (auto const frame : store.trace(trace))
+        rewritten.emplace_back(store.frame(frame));
+    return rewritten;
+}
+
+TEST(frame_rules, strip_removes_leading_matches_repeatedly)
+{
+    auto const rewritten = rewrite(frame_rules::allocators(), {
+        "ntdll!RtlpAllocateHeapInternal+0000095F", "ntdll!RtlAllocateHeap+00000020", "ucrtbase!_malloc_base+00000036",
+        "app!operator new+0000000F", "app!cache::insert+00000042", "ucrtbase!malloc+00000036", "app!main+00000005"});
+
+    ASSERT_EQ(vector<string>({"app!cache::insert+00000042", "ucrtbase!malloc+00000036", "app!main+00000005"}), rewritten);
+}
+
+TEST(frame_rules, strip_leaves_the_outermost_frame)
+{
+    ASSERT_EQ(vector<string>({"ucrtbase!malloc+36"}), rewrite(frame_rules::allocators(), {"ntdll!RtlAllocateHeap+20", "ucrtbase!malloc+36"}));
+}
+
+TEST(frame_rules, strip_matches_whole_sequences_only)
+{
+    frame_rules rules{};
+    rules.strip(vector<string_view>{"alloc!a", "alloc!b"});
+
+    ASSERT_EQ(vector<string>({"app!main+1"}), rewrite(rules, {"alloc!a+1", "alloc!b+2", "app!main+1"}));
+    ASSERT_EQ(vector<string>({"alloc!a+1", "app!main+1"}), rewrite(rules, {"alloc!a+1", "app!main+1"}));
+}
+
+TEST(frame_rules, wildcards_and_module_case_are_matched)
+{
+    frame_rules rules{};
+    rules.strip(vector<string_view>{"heap!*"}).strip(vector<string_view>{"*!allocate"});
+
+    ASSERT_EQ(vector<string>({"app!main+1"}), rewrite(rules, {"HEAP!anything+1", "other!allocate+2", "app!main+1"}));
+    ASSERT_EQ(vector<string>({"7FFB2C6E6D3B", "app!main+1"}), rewrite(rules, {"7FFB2C6E6D3B", "app!main+1"}));
+}
+
+TEST(frame_rules, collapse_keeps_outermost_frame_of_each_run)
+{
+    frame_rules rules{};
+    rules.collapse(vector<string_view>{"std!invoke", "std!function::operator()"});
+
+    auto const rewritten = rewrite(rules, {"app!lambda+1", "std!invoke+2", "std!function::operator()+3", "app!run+4", "std!invoke+5", "std!function::operator()+6", "app!main+7"});
+
+    ASSERT_EQ(vector<string>({"app!lambda+1", "std!function::operator()+3", "app!run+4", "std!function::operator()+6", "app!main+7"}), rewritten);
+}
+
+TEST(frame_rules, backtraces_differing_in_stripped_frames_share_an_id)
+{
+    trace_store store(frame_rules::allocators());
+
+    auto const first = store.intern_trace(vector<string_view>{"ntdll!RtlAllocateHeap+20", "ucrtbase!malloc+36", "app!main+5"});
+    auto const second = store.intern_trace(vector<string_view>{"ucrtbase!calloc+12", "app!main+5"});
+    auto const again = store.intern_trace(store.trace(first));
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(first, again);
+    ASSERT_EQ(1ULL, store.trace_count());
+    ASSERT_EQ(4ULL, store.frame_count());
+}
+
+TEST(frame_rules, repeated_backtraces_keep_their_rewritten_id)
+{
+    trace_store store(frame_rules::allocators());
+    vector<string_view> const raw{"ntdll!RtlAllocateHeap+20", "ucrtbase!malloc+36", "app!main+5"};
+    vector<string_view> const other{"ucrtbase!malloc+36", "app!run+9", "app!main+5"};
+
+    auto const first = store.intern_trace(raw);
+    auto const second = store.intern_trace(other);
+    auto const unchanged = store.intern_trace(vector<string_view>{"app!main+5"});
+
+    ASSERT_NE(first, second);
+    ASSERT_EQ(first, unchanged);
+    ASSERT_EQ(first, store.intern_trace(raw));
+    ASSERT_EQ(second, store.intern_trace(other));
+    ASSERT_EQ(2ULL, store.trace_count());
+}
+
+TEST(frame_rules, allocator_modules_match_ignoring_case)
+{
+    ASSERT_TRUE(frame_rules::is_allocator_module("KERNELBASE"));
+    ASSERT_TRUE(frame_rules::is_allocator_module("ucrtbased"));
+    ASSERT_FALSE(frame_rules::is_allocator_module("app"));
+    ASSERT_FALSE(frame_rules::is_allocator_module(""));
+}
+
+TEST(frame_rules, malformed_rules_are_rejected)
+{
+    frame_rules rules{};
+
+    ASSERT_THROW(rules.strip(vector<string_view>{}), std::invalid_argument);
+    ASSERT_THROW(rules.strip(vector<string_view>{"*!*"}), std::invalid_argument);
+    ASSERT_THROW(rules.strip(vector<string_view>{"app!"}), std::invalid_argument);
+    ASSERT_THROW(rules.collapse(vector<string_view>{"app!main"}), std::invalid_argument);
+    ASSERT_TRUE(rules.empty());
+}
+
+}
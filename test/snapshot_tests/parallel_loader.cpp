@@ -0,0 +1,144 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <parallel_loader.h>
+#include <snapshot_builder.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using std::make_shared;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using snapshot::model::frame_rules;
+using snapshot::model::heap_snapshot;
+using snapshot::model::load_snapshot;
+using snapshot::model::load_snapshot_parallel;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+
+namespace snapshot::parallel_loader_tests
+{
+
+/// <summary>writes a umdh log of roughly size bytes where backtraces and frames repeat throughout</summary>
+std::filesystem::path write_log(string const& name, std::size_t const size)
+{
+    auto const filename = std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".log");
+    std::ofstream stream(filename, std::ios::binary);
+    stream << "// Debug library initialized ...\n//\n\n*- - - - - - - - - - Heap 00A70000 Hogs - - - - - - - - - -\n\n";
+
+    std::size_t written{};
+    for (std::uint64_t record = 0; written < size; record++) {
+        auto const backtrace = (record * 7919ULL) % 20011ULL;
+        string text = std::to_string(0x40ULL + backtrace % 512ULL) + " bytes in 0x" + std::to_string(1 + record % 3) +
+            " allocations (@ 0x40 + 0x10) by: BackTrace" + std::to_string(backtrace) + "\n";
+        text += "        ntdll!RtlpAllocateHeapInternal+0000095F\n        ntdll!RtlAllocateHeap+00000020\n";
+        for (auto depth = 0ULL; depth < 4ULL + backtrace % 5ULL; depth++)
+            text += "        module" + std::to_string((backtrace + depth) % 37ULL) + "!function" + std::to_string((backtrace * (depth + 1)) % 997ULL) + "+00000010\n";
+        text += "\n";
+        stream << text;
+        written += text.size();
+    }
+    return filename;
+}
+
+void expect_identical(trace_store const& expected_traces, heap_snapshot const& expected, trace_store const& actual_traces, heap_snapshot const& actual)
+{
+    ASSERT_EQ(expected.trace_ids, actual.trace_ids);
+    ASSERT_EQ(expected.bytes, actual.bytes);
+    ASSERT_EQ(expected.counts, actual.counts);
+    ASSERT_EQ(expected.modules.size(), actual.modules.size());
+    for (std::size_t module = 0; module < expected.modules.size(); module++) {
+        ASSERT_EQ(expected.modules[module].module, actual.modules[module].module);
+        ASSERT_EQ(expected.modules[module].bytes, actual.modules[module].bytes);
+        ASSERT_EQ(expected.modules[module].traces, actual.modules[module].traces);
+    }
+    ASSERT_EQ(expected_traces.frame_count(), actual_traces.frame_count());
+    ASSERT_EQ(expected_traces.trace_count(), actual_traces.trace_count());
+    for (snapshot::model::frame_id frame = 0; frame < expected_traces.frame_count(); frame++)
+        ASSERT_EQ(expected_traces.frame(frame), actual_traces.frame(frame));
+    for (trace_id trace = 0; trace < expected_traces.trace_count(); trace++) {
+        auto const left = expected_traces.trace(trace);
+        auto const right = actual_traces.trace(trace);
+        ASSERT_TRUE(std::equal(left.begin(), left.end(), right.begin(), right.end()));
+    }
+}
+
+TEST(parallel_loader, matches_serial_load_for_any_worker_count)
+{
+    auto const filename = write_log("parallel_loader_matches", 6ULL * 1024ULL * 1024ULL);
+    auto const serialTraces = make_shared<trace_store>();
+    auto const serial = load_snapshot(filename, serialTraces);
+
+    for (auto const workers : {1ULL, 2ULL, 3ULL, 8ULL}) {
+        auto const traces = make_shared<trace_store>();
+        auto const parallel = load_snapshot_parallel(filename, traces, workers);
+        expect_identical(*serialTraces, serial, *traces, parallel);
+    }
+    std::filesystem::remove(filename);
+}
+
+TEST(parallel_loader, appends_to_existing_store_like_serial_load)
+{
+    auto const filename = write_log("parallel_loader_existing", 3ULL * 1024ULL * 1024ULL);
+    auto const serialTraces = make_shared<trace_store>();
+    auto const traces = make_shared<trace_store>();
+    for (auto const& store : {serialTraces, traces})
+        static_cast<void>(store->intern_trace(vector<string_view>{"module3!function1+00000010", "app!main"}));
+
+    auto const serial = load_snapshot(filename, serialTraces);
+    auto const parallel = load_snapshot_parallel(filename, traces, 4);
+
+    expect_identical(*serialTraces, serial, *traces, parallel);
+    std::filesystem::remove(filename);
+}
+
+TEST(parallel_loader, rewrites_backtraces_like_serial_load)
+{
+    auto const filename = write_log("parallel_loader_rules", 3ULL * 1024ULL * 1024ULL);
+    auto const serialTraces = make_shared<trace_store>(frame_rules::allocators());
+    auto const traces = make_shared<trace_store>(frame_rules::allocators());
+
+    auto const serial = load_snapshot(filename, serialTraces);
+    auto const parallel = load_snapshot_parallel(filename, traces, 4);
+
+    expect_identical(*serialTraces, serial, *traces, parallel);
+    ASSERT_EQ("module", traces->frame(traces->trace(parallel.trace_ids[0])[0]).substr(0, 6));
+    std::filesystem::remove(filename);
+}
+
+/// <summary>run with --gtest_also_run_disabled_tests to print load times by worker count</summary>
+TEST(parallel_loader, DISABLED_benchmark_scaling)
+{
+    auto const filename = write_log("parallel_loader_benchmark", 512ULL * 1024ULL * 1024ULL);
+    static_cast<void>(load_snapshot(filename, make_shared<trace_store>())); // warm the page cache
+
+    auto const time = [](auto&& load) {
+        auto const start = std::chrono::steady_clock::now();
+        auto const snapshot = load();
+        return std::make_pair(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), snapshot.size());
+    };
+    auto const [serialSeconds, rows] = time([&filename]() { return load_snapshot(filename, make_shared<trace_store>()); });
+    std::cout << "serial " << serialSeconds << "s for " << rows << " backtraces\n";
+    for (auto workers = 1U; workers <= std::max(1U, std::thread::hardware_concurrency()); workers *= 2) {
+        auto const [seconds, ignored] = time([&filename, workers]() { return load_snapshot_parallel(filename, make_shared<trace_store>(), workers); });
+        std::cout << workers << " workers " << seconds << "s, " << serialSeconds / seconds << "x\n";
+    }
+    std::filesystem::remove(filename);
+}
+
+}
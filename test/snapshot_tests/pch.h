@@ -0,0 +1,14 @@
+//
+// pch.h
+// Header for standard system include files.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <regex>
+
+#include "gtest/gtest.h"
+
@@ -0,0 +1,193 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot_archive.h>
+#include <varint.h>
+
+using std::chrono::seconds;
+using std::make_shared;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using snapshot::infrastructure::archive_reader;
+using snapshot::infrastructure::archive_writer;
+using snapshot::infrastructure::read_varint;
+using snapshot::infrastructure::write_varint;
+using snapshot::infrastructure::zigzag_decode;
+using snapshot::infrastructure::zigzag_encode;
+using snapshot::model::frame_rules;
+using snapshot::model::heap_snapshot;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+
+namespace snapshot::snapshot_archive_tests
+{
+
+class snapshot_archive : public testing::Test
+{
+protected:
+    std::filesystem::path filename{std::filesystem::temp_directory_path() / ("snapshot_archive_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+        ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin")};
+
+    void TearDown() override
+    {
+        std::error_code ignored{};
+        std::filesystem::remove(filename, ignored);
+    }
+};
+
+heap_snapshot make_snapshot(std::shared_ptr<trace_store const> const& traces, std::uint64_t const step)
+{
+    // a slowly changing population: most backtraces stay put, a few grow, some come and go
+    heap_snapshot snapshot{};
+    snapshot.traces = traces;
+    for (trace_id trace = 0; trace < static_cast<trace_id>(traces->trace_count()); trace++) {
+        if (trace % 7 == 0 && step % 2 == 1)
+            continue;
+        snapshot.append({trace, 64ULL + (trace % 5 == 0 ? step * 32ULL : 0ULL), 1ULL + (trace % 5 == 0 ? step : 0ULL)});
+    }
+    return snapshot;
+}
+
+std::shared_ptr<trace_store> make_traces(std::size_t const count)
+{
+    auto traces = make_shared<trace_store>();
+    for (std::size_t i = 0; i < count; i++) {
+        vector<string> const frames{"ntdll!RtlAllocateHeap+20", "app!function" + std::to_string(i % 50) + "+" + std::to_string(i)};
+        static_cast<void>(traces->intern_trace(vector<string_view>(frames.begin(), frames.end())));
+    }
+    return traces;
+}
+
+void expect_equal(heap_snapshot const& expected, heap_snapshot const& actual)
+{
+    ASSERT_EQ(expected.trace_ids, actual.trace_ids);
+    ASSERT_EQ(expected.bytes, actual.bytes);
+    ASSERT_EQ(expected.counts, actual.counts);
+}
+
+TEST(varint, round_trips_boundaries)
+{
+    for (auto const value : {0ULL, 1ULL, 127ULL, 128ULL, 16383ULL, 16384ULL, ~0ULL}) {
+        string encoded{};
+        write_varint(encoded, value);
+        string_view input = encoded;
+        std::uint64_t decoded{};
+        ASSERT_TRUE(read_varint(input, decoded));
+        ASSERT_EQ(value, decoded);
+        ASSERT_TRUE(input.empty());
+    }
+    string_view truncated{"\x80", 1};
+    std::uint64_t ignored{};
+    ASSERT_FALSE(read_varint(truncated, ignored));
+}
+
+TEST(varint, zigzag_keeps_small_magnitudes_small)
+{
+    ASSERT_EQ(0ULL, zigzag_encode(0));
+    ASSERT_EQ(1ULL, zigzag_encode(-1));
+    ASSERT_EQ(2ULL, zigzag_encode(1));
+    for (auto const value : std::initializer_list<std::int64_t>{0, -1, 1, -64, 64, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()})
+        ASSERT_EQ(value, zigzag_decode(zigzag_encode(value)));
+}
+
+TEST_F(snapshot_archive, every_snapshot_loads_as_written)
+{
+    auto const traces = make_traces(500);
+    vector<heap_snapshot> written{};
+    archive_writer::time_point const start{std::chrono::hours(24 * 365 * 50)};
+    {
+        archive_writer writer(filename, traces, 4);
+        for (auto step = 0ULL; step < 11ULL; step++) {
+            written.push_back(make_snapshot(traces, step));
+            writer.append(written.back(), start + seconds(60 * step));
+        }
+    }
+
+    archive_reader const reader(filename);
+
+    ASSERT_EQ(written.size(), reader.size());
+    ASSERT_EQ(traces->trace_count(), reader.traces()->trace_count());
+    ASSERT_EQ(traces->frame(traces->trace(123)[1]), reader.traces()->frame(reader.traces()->trace(123)[1]));
+    for (auto index = written.size(); index-- > 0;) {
+        expect_equal(written[index], reader.load(index));
+        ASSERT_EQ(start + seconds(60 * index), reader.taken(index));
+        ASSERT_EQ(reader.traces(), reader.load(index).traces);
+    }
+}
+
+TEST_F(snapshot_archive, deltas_are_smaller_than_keyframes)
+{
+    auto const traces = make_traces(2000);
+    auto const archiveSize = [this, &traces](std::size_t const snapshots, std::size_t const keyframe_interval) {
+        {
+            archive_writer writer(filename, traces, keyframe_interval);
+            for (auto step = 0ULL; step < snapshots; step++)
+                writer.append(make_snapshot(traces, step), {});
+        }
+        return std::filesystem::file_size(filename);
+    };
+
+    auto const single = archiveSize(1, 16);
+    auto const keyframe = archiveSize(2, 1) - single;
+    auto const delta = archiveSize(2, 16) - single;
+
+    // about a third of the rows change between snapshots
+    ASSERT_LT(delta, keyframe / 2);
+}
+
+TEST_F(snapshot_archive, incomplete_archive_is_rejected)
+{
+    {
+        std::ofstream stream(filename, std::ios::binary);
+        stream << "UMDHARC";
+    }
+
+    ASSERT_THROW(archive_reader{filename}, std::runtime_error);
+}
+
+TEST_F(snapshot_archive, reader_rewrites_new_traces_with_the_writers_rules)
+{
+    vector<string_view> const frames{"ntdll!RtlAllocateHeap+20", "app!main+4"};
+    auto const traces = make_shared<trace_store>(frame_rules::allocators());
+    auto const archived = traces->intern_trace(frames);
+    {
+        heap_snapshot snapshot{};
+        snapshot.traces = traces;
+        snapshot.append({archived, 64ULL, 1ULL});
+        archive_writer writer(filename, traces);
+        writer.append(snapshot, {});
+    }
+
+    archive_reader const ruled(filename, frame_rules::allocators());
+    archive_reader const unruled(filename);
+
+    ASSERT_EQ(archived, ruled.traces()->intern_trace(frames));
+    ASSERT_EQ(1ULL, ruled.traces()->trace_count());
+    ASSERT_NE(archived, unruled.traces()->intern_trace(frames));
+}
+
+TEST_F(snapshot_archive, load_out_of_range_throws)
+{
+    {
+        archive_writer writer(filename, make_traces(1));
+    }
+    archive_reader const reader(filename);
+
+    ASSERT_EQ(0ULL, reader.size());
+    ASSERT_THROW(static_cast<void>(reader.load(0)), std::out_of_range);
+}
+
+}
@@ -0,0 +1,103 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot_builder.h>
+#include "fixtures.h"
+
+using std::make_shared;
+using std::string_view;
+using std::vector;
+
+using snapshot::model::load_snapshot;
+using snapshot::model::snapshot_builder;
+using snapshot::model::trace_store;
+using snapshot::model::umdh_record;
+using snapshot::tests::fixture_path;
+
+namespace snapshot::snapshot_builder_tests
+{
+
+vector<string_view> frames_of(trace_store const& traces, snapshot::model::trace_id const trace)
+{
+    vector<string_view> frames{};
+    for (auto const frame : traces.trace(trace))
+        frames.push_back(traces.frame(frame));
+    return frames;
+}
+
+TEST(snapshot_builder, totals_repeated_backtrace)
+{
+    snapshot_builder builder(make_shared<trace_store>());
+    builder.add({7ULL, 0x40ULL, 1ULL, 0ULL, 0ULL, {"app!f+1"}});
+    builder.add({7ULL, 0x20ULL, 1ULL, 0ULL, 0ULL, {"app!f+1"}});
+
+    auto const snapshot = builder.build();
+
+    ASSERT_EQ(1ULL, snapshot.size());
+    ASSERT_EQ(0x60ULL, snapshot.bytes[0]);
+    ASSERT_EQ(2ULL, snapshot.counts[0]);
+}
+
+TEST(snapshot_builder, rows_are_in_trace_order)
+{
+    snapshot_builder builder(make_shared<trace_store>());
+    builder.add({1ULL, 10ULL, 1ULL, 0ULL, 0ULL, {"app!a"}});
+    builder.add({2ULL, 20ULL, 1ULL, 0ULL, 0ULL, {"app!b"}});
+    static_cast<void>(builder.build());
+    builder.add({2ULL, 30ULL, 1ULL, 0ULL, 0ULL, {"app!b"}});
+    builder.add({1ULL, 40ULL, 1ULL, 0ULL, 0ULL, {"app!a"}});
+
+    auto const snapshot = builder.build();
+
+    ASSERT_EQ(2ULL, snapshot.size());
+    ASSERT_EQ(0U, snapshot.trace_ids[0]);
+    ASSERT_EQ(40ULL, snapshot.bytes[0]);
+    ASSERT_EQ(1U, snapshot.trace_ids[1]);
+}
+
+TEST(snapshot_builder, snapshots_sharing_a_store_share_trace_ids)
+{
+    auto const traces = make_shared<trace_store>();
+
+    auto const log = load_snapshot(fixture_path("log.txt"), traces);
+    auto const diff = load_snapshot(fixture_path("diff.txt"), traces);
+
+    ASSERT_EQ(3ULL, log.size());
+    ASSERT_EQ(3ULL, diff.size());
+    ASSERT_EQ(vector<string_view>({"ntdll!RtlAllocateHeap+00000020", "ucrtbase!malloc+00000036", "MyService!session::open+00000110"}),
+        frames_of(*traces, log.trace_ids[1]));
+    ASSERT_EQ(log.trace_ids[1], diff.trace_ids[0]);
+    ASSERT_EQ(5ULL, traces->trace_count());
+}
+
+TEST(snapshot_builder, build_rolls_rows_up_by_module)
+{
+    auto const traces = make_shared<trace_store>();
+    snapshot_builder builder(traces);
+    builder.add({1ULL, 10ULL, 1ULL, 0ULL, 0ULL, {"ntdll!RtlAllocateHeap+20", "net!send+4"}});
+    builder.add({2ULL, 20ULL, 2ULL, 0ULL, 0ULL, {"app!a+1"}});
+    builder.add({3ULL, 30ULL, 3ULL, 0ULL, 0ULL, {"ucrtbase!malloc+36", "app!b+2"}});
+
+    auto const snapshot = builder.build();
+
+    ASSERT_EQ(2ULL, snapshot.modules.size());
+    ASSERT_EQ("net", traces->module(snapshot.modules[0].module));
+    ASSERT_EQ(10ULL, snapshot.modules[0].bytes);
+    ASSERT_EQ("app", traces->module(snapshot.modules[1].module));
+    ASSERT_EQ(50ULL, snapshot.modules[1].bytes);
+    ASSERT_EQ(5ULL, snapshot.modules[1].count);
+    ASSERT_EQ(2ULL, snapshot.modules[1].traces);
+}
+
+}
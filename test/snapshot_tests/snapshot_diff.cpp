@@ -0,0 +1,128 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <snapshot_diff.h>
+#include "fixtures.h"
+
+using std::make_shared;
+using std::vector;
+
+using snapshot::model::diff_modules;
+using snapshot::model::diff_snapshots;
+using snapshot::model::heap_snapshot;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+using snapshot::tests::make_snapshot;
+
+namespace snapshot::snapshot_diff_tests
+{
+
+TEST(snapshot_diff, reports_growth_new_and_freed_backtraces)
+{
+    auto const traces = make_shared<trace_store const>();
+    auto const before = make_snapshot(traces, {{1U, 100ULL, 1ULL}, {2U, 200ULL, 2ULL}, {4U, 50ULL, 5ULL}});
+    auto const after = make_snapshot(traces, {{2U, 500ULL, 6ULL}, {3U, 30ULL, 1ULL}, {4U, 50ULL, 5ULL}});
+
+    auto const diff = diff_snapshots(before, after);
+
+    ASSERT_EQ(vector<trace_id>({1U, 2U, 3U}), diff.trace_ids);
+    ASSERT_EQ(-100LL, diff[0].bytes_delta);
+    ASSERT_EQ(0ULL, diff[0].bytes);
+    ASSERT_EQ(-1LL, diff[0].count_delta);
+    ASSERT_EQ(300LL, diff[1].bytes_delta);
+    ASSERT_EQ(4LL, diff[1].count_delta);
+    ASSERT_EQ(500ULL, diff[1].bytes);
+    ASSERT_EQ(30LL, diff[2].bytes_delta);
+}
+
+TEST(snapshot_diff, unchanged_rows_are_kept_on_request)
+{
+    auto const traces = make_shared<trace_store const>();
+    auto const before = make_snapshot(traces, {{1U, 100ULL, 1ULL}});
+    auto const after = make_snapshot(traces, {{1U, 100ULL, 1ULL}});
+
+    ASSERT_EQ(0ULL, diff_snapshots(before, after).size());
+    ASSERT_EQ(1ULL, diff_snapshots(before, after, true).size());
+    ASSERT_EQ(0LL, diff_snapshots(before, after, true)[0].bytes_delta);
+}
+
+TEST(snapshot_diff, empty_before_reports_everything_as_growth)
+{
+    auto const traces = make_shared<trace_store const>();
+    auto const after = make_snapshot(traces, {{0U, 10ULL, 1ULL}, {7U, 70ULL, 7ULL}});
+
+    auto const diff = diff_snapshots(heap_snapshot{}, after);
+
+    ASSERT_EQ(2ULL, diff.size());
+    ASSERT_EQ(70LL, diff[1].bytes_delta);
+    ASSERT_EQ(traces, diff.traces);
+}
+
+TEST(snapshot_diff, snapshots_from_different_stores_are_rejected)
+{
+    auto const before = make_snapshot(make_shared<trace_store const>(), {{1U, 100ULL, 1ULL}});
+    auto const after = make_snapshot(make_shared<trace_store const>(), {{1U, 100ULL, 1ULL}});
+
+    ASSERT_THROW(static_cast<void>(diff_snapshots(before, after)), std::invalid_argument);
+}
+
+TEST(snapshot_diff, large_synthetic_snapshots_merge_in_order)
+{
+    auto const traces = make_shared<trace_store const>();
+    heap_snapshot before{};
+    heap_snapshot after{};
+    before.traces = traces;
+    after.traces = traces;
+    for (trace_id id = 0; id < 100000; id++) {
+        if (id % 3 != 0)
+            before.append({id, 10ULL, 1ULL});
+        if (id % 5 != 0)
+            after.append({id, id % 2 == 0 ? 20ULL : 10ULL, 1ULL});
+    }
+
+    auto const diff = diff_snapshots(before, after);
+
+    ASSERT_TRUE(std::is_sorted(diff.trace_ids.begin(), diff.trace_ids.end()));
+    std::int64_t total{};
+    for (auto const delta : diff.bytes_deltas)
+        total += delta;
+    std::int64_t expected{};
+    for (auto i = 0ULL; i < before.size(); i++)
+        expected -= static_cast<std::int64_t>(before.bytes[i]);
+    for (auto i = 0ULL; i < after.size(); i++)
+        expected += static_cast<std::int64_t>(after.bytes[i]);
+    ASSERT_EQ(expected, total);
+}
+
+TEST(snapshot_diff, module_rollups_are_compared_by_module)
+{
+    auto before = make_snapshot(nullptr, {});
+    before.modules = {{1U, 100ULL, 1ULL, 1ULL}, {2U, 200ULL, 2ULL, 2ULL}};
+    auto after = make_snapshot(nullptr, {});
+    after.modules = {{2U, 500ULL, 5ULL, 3ULL}, {4U, 40ULL, 4ULL, 1ULL}};
+
+    auto const modules = diff_modules(before, after);
+
+    ASSERT_EQ(3ULL, modules.size());
+    ASSERT_EQ(1U, modules[0].module);
+    ASSERT_EQ(-100LL, modules[0].bytes_delta);
+    ASSERT_EQ(0ULL, modules[0].bytes);
+    ASSERT_EQ(2U, modules[1].module);
+    ASSERT_EQ(300LL, modules[1].bytes_delta);
+    ASSERT_EQ(3LL, modules[1].count_delta);
+    ASSERT_EQ(3ULL, modules[1].traces);
+    ASSERT_EQ(40LL, modules[2].bytes_delta);
+}
+
+}
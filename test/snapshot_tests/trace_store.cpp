@@ -0,0 +1,103 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <trace_store.h>
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+using snapshot::model::frame_id;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+
+namespace snapshot::trace_store_tests
+{
+
+TEST(trace_store, equal_frames_share_an_id)
+{
+    trace_store store{};
+
+    auto const first = store.intern_frame("ntdll!RtlAllocateHeap+20");
+    auto const second = store.intern_frame("app!main+5");
+    auto const repeated = store.intern_frame(string("ntdll!RtlAllocateHeap+20"));
+
+    ASSERT_EQ(first, repeated);
+    ASSERT_NE(first, second);
+    ASSERT_EQ(2ULL, store.frame_count());
+    ASSERT_EQ("app!main+5", store.frame(second));
+}
+
+TEST(trace_store, equal_backtraces_share_an_id)
+{
+    trace_store store{};
+    vector<string_view> const frames{"ntdll!RtlAllocateHeap+20", "app!main+5"};
+    vector<string_view> const reversed{"app!main+5", "ntdll!RtlAllocateHeap+20"};
+
+    auto const first = store.intern_trace(frames);
+    auto const other = store.intern_trace(reversed);
+    auto const repeated = store.intern_trace(frames);
+
+    ASSERT_EQ(first, repeated);
+    ASSERT_NE(first, other);
+    ASSERT_EQ(2ULL, store.trace_count());
+    ASSERT_EQ(2ULL, store.frame_count());
+    ASSERT_EQ("app!main+5", store.frame(store.trace(first)[1]));
+}
+
+TEST(trace_store, empty_backtrace_is_interned)
+{
+    trace_store store{};
+
+    auto const id = store.intern_trace(vector<frame_id>{});
+
+    ASSERT_TRUE(store.trace(id).empty());
+    ASSERT_EQ(id, store.intern_trace(vector<frame_id>{}));
+}
+
+TEST(trace_store, ids_are_dense_and_survive_growth)
+{
+    trace_store store{};
+    vector<trace_id> ids{};
+    for (auto i = 0; i < 5000; i++) {
+        vector<string> const frames{"module!function+" + std::to_string(i % 700), "app!caller+" + std::to_string(i)};
+        ids.push_back(store.intern_trace(vector<string_view>(frames.begin(), frames.end())));
+    }
+
+    ASSERT_EQ(5000ULL, store.trace_count());
+    ASSERT_EQ(5700ULL, store.frame_count());
+    for (auto i = 0; i < 5000; i++) {
+        ASSERT_EQ(static_cast<trace_id>(i), ids[i]);
+        ASSERT_EQ("app!caller+" + std::to_string(i), store.frame(store.trace(ids[i])[1]));
+    }
+}
+
+TEST(trace_store, backtraces_are_attributed_past_allocator_frames)
+{
+    trace_store store{};
+    vector<string_view> const frames{"7FFB2C6E6D3B", "ntdll!RtlAllocateHeap+20", "ucrtbase!malloc+36", "app!cache::insert+42", "app!main+5"};
+    vector<string_view> const allocator_only{"ntdll!RtlAllocateHeap+20", "KERNELBASE!LocalAlloc+10"};
+
+    auto const attributed = store.intern_trace(frames);
+    auto const unattributed = store.intern_trace(allocator_only);
+
+    ASSERT_EQ("app", store.module(store.module_of(attributed)));
+    ASSERT_EQ("KERNELBASE", store.module(store.module_of(unattributed)));
+    ASSERT_EQ("", store.module(store.frame_module(store.trace(attributed)[0])));
+    ASSERT_EQ(store.module_of(attributed), store.find_module("APP"));
+    ASSERT_FALSE(store.find_module("missing").has_value());
+    ASSERT_EQ(5ULL, store.module_count());
+}
+
+}
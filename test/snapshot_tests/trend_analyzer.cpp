@@ -0,0 +1,105 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <trend_analyzer.h>
+#include "fixtures.h"
+
+using std::chrono::seconds;
+using std::make_shared;
+using std::vector;
+
+using snapshot::model::heap_snapshot;
+using snapshot::model::leak_trend;
+using snapshot::model::trace_id;
+using snapshot::model::trace_store;
+using snapshot::model::trend_analyzer;
+using snapshot::tests::make_snapshot;
+
+namespace snapshot::trend_analyzer_tests
+{
+
+vector<trace_id> traces_of(vector<leak_trend> const& trends)
+{
+    vector<trace_id> traces{};
+    for (auto const& trend : trends)
+        traces.push_back(trend.trace);
+    return traces;
+}
+
+TEST(trend_analyzer, slope_matches_steady_growth)
+{
+    auto const traces = make_shared<trace_store const>();
+    trend_analyzer analyzer{};
+    trend_analyzer::time_point const start{};
+    for (auto i = 0; i < 5; i++)
+        analyzer.add(make_snapshot(traces, {{3U, 1000ULL + 100ULL * i, 1ULL}}), start + seconds(10 * i));
+
+    auto const trend = analyzer.find(3U);
+
+    ASSERT_TRUE(trend.has_value());
+    ASSERT_DOUBLE_EQ(10.0, trend.value().bytes_per_second);
+    ASSERT_EQ(1400ULL, trend.value().bytes);
+    ASSERT_EQ(5ULL, trend.value().samples);
+}
+
+TEST(trend_analyzer, top_ranks_steepest_first_and_skips_shrinking)
+{
+    auto const traces = make_shared<trace_store const>();
+    trend_analyzer analyzer{};
+    trend_analyzer::time_point const start{};
+    for (auto i = 0ULL; i < 4ULL; i++) {
+        analyzer.add(make_snapshot(traces, {
+            {0U, 100ULL, 1ULL},
+            {1U, 100ULL + 10ULL * i, 1ULL},
+            {2U, 100ULL + 50ULL * i, 1ULL},
+            {3U, 1000ULL - 100ULL * i, 1ULL},
+            {4U, 100ULL + 20ULL * i, 1ULL},
+        }), start + seconds(i));
+    }
+
+    ASSERT_EQ(vector<trace_id>({2U, 4U}), traces_of(analyzer.top(2)));
+    ASSERT_EQ(vector<trace_id>({2U, 4U, 1U}), traces_of(analyzer.top(10)));
+}
+
+TEST(trend_analyzer, absent_backtrace_counts_as_zero_bytes)
+{
+    auto const traces = make_shared<trace_store const>();
+    trend_analyzer analyzer{};
+    trend_analyzer::time_point const start{};
+    analyzer.add(make_snapshot(traces, {{0U, 100ULL, 1ULL}}), start);
+    analyzer.add(make_snapshot(traces, {{1U, 10ULL, 1ULL}}), start + seconds(1));
+
+    auto const freed = analyzer.find(0U);
+    auto const started = analyzer.find(1U);
+
+    ASSERT_DOUBLE_EQ(-100.0, freed.value().bytes_per_second);
+    ASSERT_EQ(0ULL, freed.value().bytes);
+    ASSERT_DOUBLE_EQ(10.0, started.value().bytes_per_second);
+    ASSERT_TRUE(analyzer.top(5).empty());
+    ASSERT_EQ(vector<trace_id>({1U}), traces_of(analyzer.top(5, 1)));
+}
+
+TEST(trend_analyzer, out_of_order_snapshot_is_rejected)
+{
+    auto const traces = make_shared<trace_store const>();
+    trend_analyzer analyzer{};
+    trend_analyzer::time_point const start{};
+    analyzer.add(make_snapshot(traces, {}), start + seconds(5));
+
+    ASSERT_THROW(analyzer.add(make_snapshot(traces, {}), start), std::invalid_argument);
+    ASSERT_THROW(analyzer.add(make_snapshot(make_shared<trace_store const>(), {}), start + seconds(6)), std::invalid_argument);
+    ASSERT_EQ(1ULL, analyzer.snapshot_count());
+}
+
+}
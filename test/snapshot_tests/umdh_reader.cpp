@@ -0,0 +1,197 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <umdh_reader.h>
+#include "fixtures.h"
+
+using std::string_view;
+using std::vector;
+
+using snapshot::infrastructure::umdh_file_reader;
+using snapshot::infrastructure::umdh_reader;
+using snapshot::model::umdh_format;
+using snapshot::model::umdh_radix;
+using snapshot::model::umdh_record;
+using snapshot::tests::fixture_path;
+
+namespace snapshot::umdh_reader_tests
+{
+
+TEST(umdh_reader, reads_current_log_records)
+{
+    umdh_reader reader(
+        "0000A0 bytes in 0x2 allocations (@ 0x50 + 0x10) by: BackTrace1F\n"
+        "\tntdll!RtlAllocateHeap+20\n"
+        "\tapp!main+5\n"
+        "\n");
+    umdh_record record{};
+
+    ASSERT_TRUE(reader.read_next(record));
+    ASSERT_EQ(umdh_format::LOG, reader.format());
+    ASSERT_EQ(0x1FULL, record.backtrace_id);
+    ASSERT_EQ(0xA0ULL, record.bytes);
+    ASSERT_EQ(2ULL, record.count);
+    ASSERT_EQ(vector<string_view>({"ntdll!RtlAllocateHeap+20", "app!main+5"}), record.frames);
+    ASSERT_FALSE(reader.read_next(record));
+}
+
+TEST(umdh_reader, reads_legacy_log_record_as_single_allocation)
+{
+    umdh_reader reader("40 bytes + 18 at 35A838 by BackTrace53\n  app!f+1\n");
+    umdh_record record{};
+
+    ASSERT_TRUE(reader.read_next(record));
+    ASSERT_EQ(0x53ULL, record.backtrace_id);
+    ASSERT_EQ(0x40ULL, record.bytes);
+    ASSERT_EQ(1ULL, record.count);
+    ASSERT_EQ(vector<string_view>({"app!f+1"}), record.frames);
+}
+
+TEST(umdh_reader, carriage_returns_are_not_part_of_frames)
+{
+    umdh_reader reader("+ 16 ( 16 - 0) 1 allocs\tBackTrace1\r\n+ 1 ( 1 - 0)\tBackTrace1\tallocations\r\n\r\n\tapp!f\r\n\r\n");
+    umdh_record record{};
+
+    ASSERT_TRUE(reader.read_next(record));
+    ASSERT_EQ(umdh_format::DIFF, reader.format());
+    ASSERT_EQ(vector<string_view>({"app!f"}), record.frames);
+}
+
+TEST(umdh_reader, frames_view_the_source_text)
+{
+    string_view const text = "10 bytes in 0x1 allocations (@ 0x10 + 0x0) by: BackTrace1\n\tapp!f\n";
+    umdh_reader reader(text);
+    umdh_record record{};
+
+    ASSERT_TRUE(reader.read_next(record));
+    ASSERT_GE(record.frames[0].data(), text.data());
+    ASSERT_LT(record.frames[0].data(), text.data() + text.size());
+}
+
+TEST(umdh_reader, record_without_frames_leaves_next_header_unread)
+{
+    umdh_reader reader(
+        "10 bytes in 0x1 allocations (@ 0x10 + 0x0) by: BackTrace1\n"
+        "20 bytes in 0x1 allocations (@ 0x20 + 0x0) by: BackTrace2\n"
+        "\tapp!f\n");
+    umdh_record record{};
+
+    ASSERT_TRUE(reader.read_next(record));
+    ASSERT_TRUE(record.frames.empty());
+    ASSERT_TRUE(reader.read_next(record));
+    ASSERT_EQ(2ULL, record.backtrace_id);
+    ASSERT_EQ(1ULL, record.frames.size());
+}
+
+TEST(umdh_reader, unrecognised_lines_are_skipped)
+{
+    umdh_reader reader("DBGHELP: app - export symbols\nDB bytes are not a record\n");
+    umdh_record record{};
+
+    ASSERT_FALSE(reader.read_next(record));
+    ASSERT_EQ(umdh_format::UNKNOWN, reader.format());
+}
+
+TEST(umdh_reader, reads_diff_fixture)
+{
+    umdh_file_reader reader(fixture_path("diff.txt"));
+    umdh_record record{};
+    vector<umdh_record> records{};
+    while (reader.read_next(record))
+        records.push_back(record);
+
+    ASSERT_EQ(umdh_format::DIFF, reader.format());
+    ASSERT_EQ(3ULL, records.size());
+
+    ASSERT_EQ(1ULL, records[0].backtrace_id);
+    ASSERT_EQ(0xF110ULL, records[0].bytes);
+    ASSERT_EQ(0x9DF0ULL, records[0].previous_bytes);
+    ASSERT_EQ(0x3AULL, records[0].count);
+    ASSERT_EQ(0x20ULL, records[0].previous_count);
+    ASSERT_EQ(4ULL, records[0].frames.size());
+    ASSERT_EQ("MyService!cache::insert+00000042", records[0].frames.back());
+
+    ASSERT_EQ(0x2AULL, records[1].backtrace_id);
+    ASSERT_EQ(0x1280ULL, records[1].bytes);
+    ASSERT_EQ(0x840ULL, records[1].previous_bytes);
+    ASSERT_EQ(8ULL, records[1].count);
+    ASSERT_EQ(6ULL, records[1].previous_count);
+
+    ASSERT_EQ(0xFFULL, records[2].backtrace_id);
+    ASSERT_EQ(0ULL, records[2].bytes);
+    ASSERT_EQ(0x100ULL, records[2].previous_bytes);
+    ASSERT_EQ(1ULL, records[2].previous_count);
+}
+
+TEST(umdh_reader, reads_decimal_diff_fixture)
+{
+    umdh_file_reader reader(fixture_path("diff_decimal.txt"), umdh_radix::DECIMAL);
+    umdh_record record{};
+    vector<umdh_record> records{};
+    while (reader.read_next(record))
+        records.push_back(record);
+
+    ASSERT_EQ(umdh_format::DIFF, reader.format());
+    ASSERT_EQ(3ULL, records.size());
+
+    ASSERT_EQ(1ULL, records[0].backtrace_id);
+    ASSERT_EQ(5320ULL, records[0].bytes);
+    ASSERT_EQ(0ULL, records[0].previous_bytes);
+    ASSERT_EQ(1ULL, records[0].count);
+    ASSERT_EQ(4ULL, records[0].frames.size());
+
+    ASSERT_EQ(0x2AULL, records[1].backtrace_id);
+    ASSERT_EQ(1280ULL, records[1].bytes);
+    ASSERT_EQ(640ULL, records[1].previous_bytes);
+    ASSERT_EQ(8ULL, records[1].count);
+    ASSERT_EQ(4ULL, records[1].previous_count);
+
+    ASSERT_EQ(0xFFULL, records[2].backtrace_id);
+    ASSERT_EQ(0ULL, records[2].bytes);
+    ASSERT_EQ(100ULL, records[2].previous_bytes);
+    ASSERT_EQ(1ULL, records[2].previous_count);
+}
+
+TEST(umdh_reader, reads_log_fixture)
+{
+    umdh_file_reader reader(fixture_path("log.txt"));
+    umdh_record record{};
+    vector<umdh_record> records{};
+    while (reader.read_next(record))
+        records.push_back(record);
+
+    ASSERT_EQ(umdh_format::LOG, reader.format());
+    ASSERT_EQ(3ULL, records.size());
+    ASSERT_EQ(0x14C8ULL, records[0].bytes);
+    ASSERT_EQ("7FFB2C6E6D3B", records[0].frames.front());
+    ASSERT_EQ(0x280ULL, records[1].bytes);
+    ASSERT_EQ(4ULL, records[1].count);
+    ASSERT_EQ(0x53ULL, records[2].backtrace_id);
+}
+
+TEST(umdh_reader, find_record_skips_to_next_header)
+{
+    string_view const text = "// comment\n10 bytes in 0x1 allocations (@ 0x10 + 0x0) by: BackTrace1\n\tapp!f\n\n20 bytes in 0x1 allocations (@ 0x20 + 0x0) by: BackTrace2\n";
+
+    ASSERT_EQ(11ULL, umdh_reader::find_record(text, 0));
+    ASSERT_EQ(text.find("20 bytes"), umdh_reader::find_record(text, 12));
+    ASSERT_EQ(text.size(), umdh_reader::find_record(text, text.find("20 bytes") + 1));
+}
+
+TEST(umdh_file_reader, throws_when_file_not_found)
+{
+    ASSERT_THROW(umdh_file_reader(fixture_path("missing.txt")), std::system_error);
+}
+
+}
@@ -0,0 +1,153 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/co_task.h>
+#include <tasks/task_action.h>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using std::vector;
+using namespace std::chrono_literals;
+
+using tasks::co_task;
+using tasks::executor;
+
+namespace tasks::co_task_tests
+{
+
+class future_action final : public task_action
+{
+public:
+    std::future<task_action_result> process_async() override
+    {
+        return std::async(std::launch::deferred, []() { return task_action_result{task_state::COMPLETE, 0ms}; });
+    }
+};
+
+class capture_action final : public co_task_action
+{
+public:
+    explicit capture_action(executor& pool)
+        : m_pool(&pool)
+    {
+    }
+    co_task<task_action_result> process_async() override
+    {
+        co_await resume_on(*m_pool);
+        auto const parsed = co_await parse();
+        co_await resume_on(*m_pool);
+        co_return task_action_result{parsed ? task_state::COMPLETE : task_state::FAILED, 0ms};
+    }
+
+private:
+    executor* m_pool;
+
+    static co_task<bool> parse()
+    {
+        co_return true;
+    }
+};
+
+static_assert(TaskAction<future_action>);
+static_assert(TaskAction<capture_action>);
+static_assert(!TaskAction<int>);
+
+co_task<int> value_of(int const value)
+{
+    co_return value;
+}
+
+co_task<int> sum_of(int const count)
+{
+    auto total = 0;
+    for (auto i = 0; i < count; i++)
+        total += co_await value_of(i);
+    co_return total;
+}
+
+co_task<int> failing()
+{
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+co_task<std::thread::id> hop(executor& pool)
+{
+    co_await resume_on(pool);
+    co_return std::this_thread::get_id();
+}
+
+TEST(co_task, does_not_run_until_started)
+{
+    auto work = value_of(3);
+
+    ASSERT_FALSE(work.done());
+    ASSERT_THROW(static_cast<void>(work.result()), std::logic_error);
+    work.start();
+    ASSERT_TRUE(work.done());
+    ASSERT_EQ(3, work.result());
+}
+
+TEST(co_task, long_chain_of_awaits_does_not_grow_the_stack)
+{
+    auto work = sum_of(50000);
+    work.start();
+
+    ASSERT_EQ(49999 * 25000, work.result());
+}
+
+TEST(co_task, exception_reaches_awaiter)
+{
+    auto outer = [](co_task<int> inner) -> co_task<bool> {
+        try {
+            static_cast<void>(co_await inner);
+        } catch (std::runtime_error const&) {
+            co_return true;
+        }
+        co_return false;
+    }(failing());
+    outer.start();
+
+    ASSERT_TRUE(outer.result());
+}
+
+TEST(co_task, resume_on_continues_on_a_worker)
+{
+    executor pool{1};
+    auto work = hop(pool);
+    work.start();
+    pool.wait_idle();
+
+    ASSERT_TRUE(work.done());
+    ASSERT_NE(std::this_thread::get_id(), work.result());
+}
+
+TEST(co_task, many_actions_share_one_worker_without_blocking_it)
+{
+    executor pool{1};
+    vector<capture_action> actions(64, capture_action(pool));
+    vector<co_task<task_action_result>> running{};
+    for (auto& action : actions) {
+        running.push_back(action.process_async());
+        running.back().start();
+    }
+    pool.wait_idle();
+
+    for (auto& work : running)
+        ASSERT_EQ(task_state::COMPLETE, work.result().first);
+}
+
+}
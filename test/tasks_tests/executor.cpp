@@ -0,0 +1,159 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/executor.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using std::vector;
+
+using tasks::executor;
+
+namespace tasks::executor_tests
+{
+
+class counting_task final : public task
+{
+public:
+    explicit counting_task(std::atomic<int>& count)
+        : m_count(count)
+    {
+    }
+    void process() override
+    {
+        m_count++;
+    }
+
+private:
+    std::atomic<int>& m_count;
+};
+
+/// <summary>processes node index then submits its two children, the tasks forming a binary tree over nodes</summary>
+class tree_task final : public task
+{
+public:
+    tree_task(executor& pool, vector<tree_task>& nodes, std::size_t const index)
+        : m_pool(&pool)
+        , m_nodes(&nodes)
+        , m_index(index)
+    {
+    }
+    void process() override
+    {
+        visits++;
+        for (auto const child : {m_index * 2 + 1, m_index * 2 + 2}) {
+            if (child < m_nodes->size())
+                m_pool->submit((*m_nodes)[child]);
+        }
+    }
+
+    int visits{};
+
+private:
+    executor* m_pool;
+    vector<tree_task>* m_nodes;
+    std::size_t m_index;
+};
+
+class failing_task final : public task
+{
+public:
+    void process() override
+    {
+        throw std::runtime_error("failed");
+    }
+};
+
+vector<tree_task> make_tree(executor& pool, std::size_t const size)
+{
+    vector<tree_task> nodes{};
+    nodes.reserve(size);
+    for (std::size_t index = 0; index < size; index++)
+        nodes.emplace_back(pool, nodes, index);
+    return nodes;
+}
+
+TEST(executor, processes_tasks_submitted_from_outside)
+{
+    std::atomic<int> count{};
+    vector<counting_task> work(1000, counting_task(count));
+    executor pool(4);
+
+    for (auto& item : work)
+        pool.submit(item);
+    pool.wait_idle();
+
+    ASSERT_EQ(1000, count.load());
+    ASSERT_EQ(4ULL, pool.worker_count());
+}
+
+TEST(executor, tasks_submitted_by_tasks_run_exactly_once)
+{
+    executor pool(4);
+    auto nodes = make_tree(pool, 50000);
+
+    pool.submit(nodes[0]);
+    pool.wait_idle();
+
+    ASSERT_TRUE(std::all_of(nodes.begin(), nodes.end(), [](tree_task const& node) { return node.visits == 1; }));
+}
+
+TEST(executor, wait_idle_rethrows_task_exception_once)
+{
+    std::atomic<int> count{};
+    counting_task counter(count);
+    failing_task failure{};
+    executor pool(2);
+
+    pool.submit(failure);
+    pool.submit(counter);
+
+    ASSERT_THROW(pool.wait_idle(), std::runtime_error);
+    ASSERT_EQ(1, count.load());
+    ASSERT_NO_THROW(pool.wait_idle());
+}
+
+TEST(executor, destruction_processes_queued_tasks)
+{
+    std::atomic<int> count{};
+    vector<counting_task> work(100, counting_task(count));
+    {
+        executor pool(1);
+        for (auto& item : work)
+            pool.submit(item);
+    }
+
+    ASSERT_EQ(100, count.load());
+}
+
+/// <summary>run with --gtest_also_run_disabled_tests to print throughput by worker count</summary>
+TEST(executor, DISABLED_benchmark_throughput)
+{
+    constexpr std::size_t TASKS = 4'000'000;
+    for (auto workers = 1U; workers <= std::max(1U, std::thread::hardware_concurrency()); workers *= 2) {
+        executor pool(workers);
+        auto nodes = make_tree(pool, TASKS);
+
+        auto const start = std::chrono::steady_clock::now();
+        pool.submit(nodes[0]);
+        pool.wait_idle();
+        auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << workers << " workers " << static_cast<double>(TASKS) / seconds << " tasks/s\n";
+    }
+}
+
+}
@@ -0,0 +1,209 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/executor.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using std::vector;
+using namespace std::chrono_literals;
+
+using tasks::executor;
+
+namespace tasks::task_tests
+{
+
+class stepping_task final : public task
+{
+public:
+    void process() override
+    {
+    }
+    bool step(task_state const value)
+    {
+        return update_task_state(value);
+    }
+    void report(std::chrono::milliseconds const value)
+    {
+        update_time_remaining(value);
+    }
+};
+
+class sleeping_task final : public task
+{
+public:
+    explicit sleeping_task(std::chrono::milliseconds const duration, bool const fail = false)
+        : m_duration(duration)
+        , m_fail(fail)
+    {
+    }
+    void process() override
+    {
+        std::this_thread::sleep_for(m_duration);
+        if (m_fail)
+            throw std::runtime_error("failed");
+    }
+
+private:
+    std::chrono::milliseconds m_duration;
+    bool m_fail;
+};
+
+TEST(task, state_follows_pending_ready_running_complete)
+{
+    stepping_task work{};
+
+    ASSERT_FALSE(work.step(task_state::RUNNING));
+    ASSERT_TRUE(work.mark_ready());
+    ASSERT_FALSE(work.mark_ready());
+    ASSERT_FALSE(work.step(task_state::COMPLETE));
+    ASSERT_TRUE(work.step(task_state::RUNNING));
+    ASSERT_FALSE(work.mark_ready());
+    ASSERT_TRUE(work.step(task_state::FAILED));
+    ASSERT_EQ(task_state::FAILED, work.get_current_state());
+    ASSERT_TRUE(work.mark_ready());
+}
+
+TEST(task, transition_fails_when_state_is_not_expected)
+{
+    stepping_task work{};
+    static_cast<void>(work.mark_ready());
+
+    ASSERT_FALSE(work.transition(task_state::RUNNING, task_state::COMPLETE));
+    ASSERT_FALSE(work.transition(task_state::READY, task_state::COMPLETE));
+    ASSERT_TRUE(work.transition(task_state::READY, task_state::RUNNING));
+    ASSERT_EQ(task_state::RUNNING, work.get_current_state());
+}
+
+TEST(task, only_one_racing_transition_succeeds)
+{
+    constexpr auto attempts = 200;
+    for (auto attempt = 0; attempt < attempts; attempt++) {
+        stepping_task work{};
+        static_cast<void>(work.mark_ready());
+        std::atomic<int> started{};
+        {
+            vector<std::jthread> threads{};
+            for (auto i = 0; i < 4; i++)
+                threads.emplace_back([&work, &started]() {
+                    if (work.transition(task_state::READY, task_state::RUNNING))
+                        started++;
+                });
+        }
+        ASSERT_EQ(1, started.load());
+    }
+}
+
+TEST(task, only_one_racing_finish_succeeds)
+{
+    constexpr auto attempts = 200;
+    stepping_task work{};
+    for (auto attempt = 0; attempt < attempts; attempt++) {
+        static_cast<void>(work.mark_ready());
+        ASSERT_TRUE(work.transition(task_state::READY, task_state::RUNNING));
+        std::atomic<int> finished{};
+        {
+            vector<std::jthread> threads{};
+            for (auto i = 0; i < 4; i++)
+                threads.emplace_back([&work, &finished, i]() {
+                    if (work.transition(task_state::RUNNING, i % 2 == 0 ? task_state::COMPLETE : task_state::FAILED))
+                        finished++;
+                });
+        }
+        ASSERT_EQ(1, finished.load());
+        ASSERT_NE(task_state::RUNNING, work.get_current_state());
+    }
+}
+
+TEST(task, reported_time_remaining_counts_down_while_running)
+{
+    stepping_task work{};
+    static_cast<void>(work.mark_ready());
+    static_cast<void>(work.step(task_state::RUNNING));
+    work.report(10s);
+
+    auto const remaining = work.get_estimated_time_remaining();
+    ASSERT_LE(remaining, 10s);
+    ASSERT_GT(remaining, 9s);
+
+    static_cast<void>(work.step(task_state::COMPLETE));
+    ASSERT_EQ(std::chrono::milliseconds::zero(), work.get_estimated_time_remaining());
+}
+
+TEST(task, estimate_before_running_is_learned_from_previous_runs)
+{
+    stepping_task work{};
+    ASSERT_EQ(std::chrono::milliseconds::zero(), work.get_estimated_time_remaining());
+
+    static_cast<void>(work.mark_ready());
+    static_cast<void>(work.step(task_state::RUNNING));
+    std::this_thread::sleep_for(20ms);
+    static_cast<void>(work.step(task_state::COMPLETE));
+    static_cast<void>(work.mark_ready());
+
+    ASSERT_GE(work.get_estimated_time_remaining(), 20ms);
+}
+
+TEST(task, estimate_reported_before_running_is_used_for_the_next_run_only)
+{
+    stepping_task work{};
+    work.report(1h);
+    ASSERT_EQ(std::chrono::milliseconds(1h), work.get_estimated_time_remaining());
+
+    static_cast<void>(work.mark_ready());
+    static_cast<void>(work.step(task_state::RUNNING));
+    ASSERT_GT(work.get_estimated_time_remaining(), 59min);
+    std::this_thread::sleep_for(20ms);
+    static_cast<void>(work.step(task_state::COMPLETE));
+    static_cast<void>(work.mark_ready());
+
+    // the run took its real time rather than starting an hour ahead, so the average is learned from it
+    auto const estimate = work.get_estimated_time_remaining();
+    ASSERT_GE(estimate, 20ms);
+    ASSERT_LT(estimate, 1min);
+}
+
+TEST(task, executor_moves_ready_task_to_complete_or_failed)
+{
+    executor pool{2};
+    sleeping_task succeeds{1ms};
+    sleeping_task fails{1ms, true};
+    sleeping_task untracked{1ms};
+    static_cast<void>(succeeds.mark_ready());
+    static_cast<void>(fails.mark_ready());
+
+    pool.submit(succeeds);
+    pool.submit(fails);
+    pool.submit(untracked);
+    ASSERT_THROW(pool.wait_idle(), std::runtime_error);
+
+    ASSERT_EQ(task_state::COMPLETE, succeeds.get_current_state());
+    ASSERT_EQ(task_state::FAILED, fails.get_current_state());
+    ASSERT_EQ(task_state::PENDING, untracked.get_current_state());
+}
+
+TEST(task, copy_carries_state_and_timings)
+{
+    stepping_task work{};
+    static_cast<void>(work.mark_ready());
+
+    auto const copy = work;
+
+    ASSERT_EQ(task_state::READY, copy.get_current_state());
+}
+
+}
@@ -0,0 +1,119 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/task_action_factory.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using std::string;
+using namespace std::chrono_literals;
+
+namespace tasks::task_action_factory_tests
+{
+
+class start_action final : public task_action
+{
+public:
+    std::future<task_action_result> process_async() override
+    {
+        std::promise<task_action_result> result{};
+        result.set_value({task_state::RUNNING, 5ms});
+        return result.get_future();
+    }
+    [[nodiscard]] string name() const
+    {
+        return "start";
+    }
+};
+
+/// <summary>satisfies TaskAction without deriving from task_action</summary>
+class finish_action final
+{
+public:
+    explicit finish_action(std::chrono::milliseconds const remaining = 0ms)
+        : m_remaining(remaining)
+    {
+    }
+    std::future<task_action_result> process_async()
+    {
+        std::promise<task_action_result> result{};
+        result.set_value({task_state::COMPLETE, m_remaining});
+        return result.get_future();
+    }
+    [[nodiscard]] string name() const
+    {
+        return "finish";
+    }
+
+private:
+    std::chrono::milliseconds m_remaining;
+};
+
+using factory = task_action_factory<
+    task_action_registration<task_state::READY, start_action>,
+    task_action_registration<task_state::RUNNING, finish_action>>;
+
+static_assert(factory::contains<task_state::READY>);
+static_assert(!factory::contains<task_state::PENDING>);
+static_assert(std::is_same_v<finish_action, factory::action_type<task_state::RUNNING>>);
+static_assert(factory::has_action(task_state::RUNNING));
+static_assert(!factory::has_action(task_state::FAILED));
+
+TEST(task_action_factory, dispatch_reaches_the_action_registered_for_state)
+{
+    factory actions{};
+
+    ASSERT_EQ("start", actions.dispatch(task_state::READY, [](auto const& action) { return action.name(); }));
+    ASSERT_EQ("finish", actions.dispatch(task_state::RUNNING, [](auto const& action) { return action.name(); }));
+}
+
+TEST(task_action_factory, process_async_follows_the_state_machine)
+{
+    factory actions{};
+
+    auto state = task_state::READY;
+    state = actions.process_async(state).get().first;
+    ASSERT_EQ(task_state::RUNNING, state);
+    state = actions.process_async(state).get().first;
+    ASSERT_EQ(task_state::COMPLETE, state);
+}
+
+TEST(task_action_factory, actions_are_constructed_from_arguments_in_registration_order)
+{
+    factory actions{start_action{}, finish_action{7ms}};
+
+    ASSERT_EQ(7ms, actions.get<task_state::RUNNING>().process_async().get().second);
+}
+
+TEST(task_action_factory, single_registration_factory_is_copied_not_forwarded)
+{
+    using single = task_action_factory<task_action_registration<task_state::RUNNING, finish_action>>;
+    single original{finish_action{7ms}};
+
+    single copy(original);
+    ASSERT_EQ(7ms, copy.get<task_state::RUNNING>().process_async().get().second);
+
+    single moved(std::move(copy));
+    ASSERT_EQ(7ms, moved.get<task_state::RUNNING>().process_async().get().second);
+}
+
+TEST(task_action_factory, unregistered_state_throws_invalid_argument)
+{
+    factory actions{};
+
+    ASSERT_THROW(static_cast<void>(actions.process_async(task_state::PENDING)), std::invalid_argument);
+}
+
+}
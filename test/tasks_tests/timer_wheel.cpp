@@ -0,0 +1,162 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <tasks/timer_wheel.h>
+#include <chrono>
+#include <stdexcept>
+
+using std::vector;
+using namespace std::chrono_literals;
+
+using tasks::timer_wheel;
+
+namespace tasks::timer_wheel_tests
+{
+
+class timed_task final : public task
+{
+public:
+    void process() override
+    {
+        static_cast<void>(update_task_state(task_state::RUNNING));
+        static_cast<void>(update_task_state(task_state::COMPLETE));
+    }
+};
+
+class timer_wheel_fixture : public ::testing::Test
+{
+protected:
+    timer_wheel::clock::time_point const start{timer_wheel::clock::now()};
+    timer_wheel wheel{1ms, start};
+    vector<task*> ready{};
+};
+
+TEST_F(timer_wheel_fixture, task_is_not_ready_before_it_is_due)
+{
+    timed_task work{};
+    static_cast<void>(wheel.schedule(work, start + 10ms));
+
+    ASSERT_EQ(0ULL, wheel.advance(start + 9ms, ready));
+    ASSERT_EQ(task_state::PENDING, work.get_current_state());
+    ASSERT_EQ(1ULL, wheel.advance(start + 10ms, ready));
+    ASSERT_EQ(task_state::READY, work.get_current_state());
+    ASSERT_EQ(vector<task*>({&work}), ready);
+    ASSERT_EQ(0ULL, wheel.size());
+}
+
+TEST_F(timer_wheel_fixture, due_time_between_ticks_is_rounded_up)
+{
+    timed_task work{};
+    static_cast<void>(wheel.schedule(work, start + 2500us));
+
+    ASSERT_EQ(0ULL, wheel.advance(start + 2999us, ready));
+    ASSERT_EQ(1ULL, wheel.advance(start + 3ms, ready));
+}
+
+TEST_F(timer_wheel_fixture, timers_on_every_level_fire_in_order)
+{
+    vector<timed_task> work(5);
+    vector<timer_wheel::clock::duration> const delays{3ms, 700ms, 90s, 5h, 60 * 24h};
+    for (std::size_t i = 0; i < work.size(); i++)
+        static_cast<void>(wheel.schedule(work[i], start + delays[i]));
+
+    for (std::size_t i = 0; i < work.size(); i++) {
+        ASSERT_EQ(0ULL, wheel.advance(start + delays[i] - 1ms, ready));
+        ASSERT_EQ(1ULL, wheel.advance(start + delays[i], ready));
+        ASSERT_EQ(&work[i], ready.back());
+    }
+}
+
+TEST_F(timer_wheel_fixture, cancelled_timer_does_not_fire_and_handle_goes_stale)
+{
+    timed_task first{};
+    timed_task second{};
+    auto const cancelled = wheel.schedule(first, start + 5ms);
+    auto const fired = wheel.schedule(second, start + 5ms);
+
+    ASSERT_TRUE(wheel.cancel(cancelled));
+    ASSERT_FALSE(wheel.cancel(cancelled));
+    ASSERT_EQ(1ULL, wheel.advance(start + 5ms, ready));
+    ASSERT_EQ(vector<task*>({&second}), ready);
+    ASSERT_FALSE(wheel.cancel(fired));
+
+    // freed nodes are reused, the old handles must not cancel the new timer
+    auto const reused = wheel.schedule(first, start + 8ms);
+    ASSERT_TRUE(reused.index == cancelled.index || reused.index == fired.index);
+    ASSERT_FALSE(wheel.cancel(cancelled));
+    ASSERT_FALSE(wheel.cancel(fired));
+    ASSERT_EQ(1ULL, wheel.size());
+}
+
+TEST_F(timer_wheel_fixture, periodic_timer_keeps_its_schedule_and_skips_missed_periods)
+{
+    timed_task work{};
+    auto const handle = wheel.schedule(work, start + 10ms, 10ms);
+
+    ASSERT_EQ(1ULL, wheel.advance(start + 13ms, ready));
+    work.process();
+    ASSERT_EQ(0ULL, wheel.advance(start + 19ms, ready));
+    ASSERT_EQ(1ULL, wheel.advance(start + 20ms, ready));
+    work.process();
+
+    // 30ms to 60ms were missed, the next firing is 70ms rather than a burst of catch up firings
+    ASSERT_EQ(1ULL, wheel.advance(start + 65ms, ready));
+    work.process();
+    ASSERT_EQ(0ULL, wheel.advance(start + 69ms, ready));
+    ASSERT_EQ(1ULL, wheel.advance(start + 70ms, ready));
+    ASSERT_TRUE(wheel.cancel(handle));
+    ASSERT_EQ(0ULL, wheel.size());
+}
+
+TEST_F(timer_wheel_fixture, periodic_firing_is_skipped_while_task_is_still_ready)
+{
+    timed_task work{};
+    static_cast<void>(wheel.schedule(work, start + 1ms, 1ms));
+
+    ASSERT_EQ(1ULL, wheel.advance(start + 1ms, ready));
+    ASSERT_EQ(0ULL, wheel.advance(start + 2ms, ready));
+    work.process();
+    ASSERT_EQ(1ULL, wheel.advance(start + 3ms, ready));
+    ASSERT_EQ(2ULL, ready.size());
+    ASSERT_EQ(1ULL, wheel.size());
+}
+
+TEST_F(timer_wheel_fixture, jitter_delays_firing_within_bound_without_drifting)
+{
+    vector<timed_task> work(64);
+    for (auto& item : work)
+        static_cast<void>(wheel.schedule(item, start + 100ms, 100ms, 20ms));
+
+    ASSERT_EQ(0ULL, wheel.advance(start + 99ms, ready));
+    auto const early = wheel.advance(start + 110ms, ready);
+    ASSERT_LT(0ULL, early);
+    ASSERT_GT(work.size(), early);
+    ASSERT_EQ(work.size(), early + wheel.advance(start + 120ms, ready));
+
+    for (auto& item : work)
+        item.process();
+    ASSERT_EQ(0ULL, wheel.advance(start + 199ms, ready));
+    ASSERT_EQ(work.size(), wheel.advance(start + 220ms, ready));
+}
+
+TEST(timer_wheel, negative_period_throws)
+{
+    timer_wheel wheel{};
+    timed_task work{};
+
+    ASSERT_THROW(static_cast<void>(wheel.schedule(work, timer_wheel::clock::now(), -1ms)), std::invalid_argument);
+    ASSERT_THROW(timer_wheel(timer_wheel::clock::duration::zero()), std::invalid_argument);
+}
+
+}
@@ -0,0 +1,86 @@
+//
+// Copyright  2020 Terry Moreland
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+// to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+// and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// 
+
+#include "pch.h"
+#include <work_stealing_deque.h>
+#include <atomic>
+#include <thread>
+
+using std::vector;
+
+using tasks::work_stealing_deque;
+
+namespace tasks::work_stealing_deque_tests
+{
+
+TEST(work_stealing_deque, owner_pops_newest_and_thieves_steal_oldest)
+{
+    work_stealing_deque<int> deque{};
+    for (auto value = 1; value <= 3; value++)
+        deque.push(value);
+
+    ASSERT_EQ(3, deque.pop());
+    ASSERT_EQ(1, deque.steal());
+    ASSERT_EQ(2, deque.pop());
+    ASSERT_FALSE(deque.pop().has_value());
+    ASSERT_FALSE(deque.steal().has_value());
+}
+
+TEST(work_stealing_deque, grows_past_initial_capacity)
+{
+    work_stealing_deque<int> deque(4);
+    for (auto value = 0; value < 1000; value++)
+        deque.push(value);
+
+    ASSERT_EQ(1000ULL, deque.size());
+    for (auto value = 0; value < 500; value++)
+        ASSERT_EQ(value, deque.steal());
+    for (auto value = 999; value >= 500; value--)
+        ASSERT_EQ(value, deque.pop());
+}
+
+TEST(work_stealing_deque, every_item_is_taken_exactly_once_under_contention)
+{
+    constexpr auto ITEMS = 200000;
+    work_stealing_deque<int> deque(16);
+    vector<std::atomic<int>> taken(ITEMS);
+    std::atomic<bool> done{};
+
+    vector<std::jthread> thieves{};
+    for (auto thief = 0; thief < 3; thief++) {
+        thieves.emplace_back([&]() {
+            while (!done.load()) {
+                if (auto const value = deque.steal(); value.has_value())
+                    taken[value.value()]++;
+            }
+        });
+    }
+    for (auto value = 0; value < ITEMS; value++) {
+        deque.push(value);
+        if (value % 3 == 0) {
+            if (auto const popped = deque.pop(); popped.has_value())
+                taken[popped.value()]++;
+        }
+    }
+    while (auto const popped = deque.pop())
+        taken[popped.value()]++;
+    while (deque.size() != 0) {
+    }
+    done = true;
+    thieves.clear();
+
+    for (auto value = 0; value < ITEMS; value++)
+        ASSERT_EQ(1, taken[value].load()) << value;
+}
+
+}